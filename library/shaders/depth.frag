@@ -0,0 +1,6 @@
+#version 330 core
+
+void main()
+{
+    // 只需要深度值，不输出颜色
+}
@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aModel;   // 每实例模型矩阵（见 pbr.vert）
+
+// 每帧数据（std140，与 UniformBuffers.h 中的 FrameBlock 一致）
+layout (std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 camPos;
+    float time;
+};
+
+// 顶点位置反量化（见 pbr.vert）
+uniform vec3 posScale;
+uniform vec3 posBias;
+
+// 同时用于深度预渲染：表达式与 pbr.vert 保持一致，主 pass 才能以 GL_EQUAL 通过深度测试
+invariant gl_Position;
+
+void main()
+{
+    // 相机视角下只写深度（遮挡物深度 pass 和深度预渲染）
+    vec3 position = aPos * posScale + posBias;
+    vec3 worldPos = vec3(aModel * vec4(position, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
@@ -4,7 +4,7 @@ out vec4 FragColor;
 in vec3 WorldPos;
 in vec3 Normal;
 in vec2 TexCoords;
-in vec4 FragPosLightSpace;  // 光源空间位置（用于阴影采样）
+in float ViewDepth;         // 视空间深度（正值）
 
 // ===== PBR 材质贴图（Metallic-Roughness 工作流） =====
 // 这些 sampler2D 会在 C++ 中绑定：
@@ -18,67 +18,287 @@ uniform sampler2D normalMap;
 uniform sampler2D metallicMap;
 uniform sampler2D roughnessMap;
 uniform sampler2D aoMap;
-uniform sampler2D shadowMap;  // 阴影贴图
+uniform sampler2DArrayShadow shadowMap;  // 级联阴影贴图（每级一层），开启深度比较：每次采样即 2x2 双线性 PCF
+uniform sampler2DArray shadowDepthMap;   // 同一张纹理按原始深度读取（3x3 对照方案、PCSS 遮挡物搜索）
+uniform sampler2DArray shadowMomentMap;  // VSM / EVSM 的矩（每级一层，带 mipmap 和各向异性过滤）
+uniform sampler2DShadow pointShadowAtlas;  // 点光源阴影图集：每个槽位一行 6 个立方体面，开启深度比较
+
+// ===== 方向光（自然光）=====
+// std140，与 UniformBuffers.h 中的 DirectionalLightBlock 一致；没有衰减，方向已归一化
+layout (std140) uniform DirectionalLightBlock {
+    vec3 direction;  // 指向光源的单位向量（世界空间）
+    int shadowMapIndex;  // 关联的阴影贴图：0 为 shadowMap（级联数组），-1 为不投射阴影
+    vec3 radiance;   // 颜色 * 照度
+} sun;
+
+// ===== 分簇光照（见 ClusteredLighting.h）=====
+// 视锥体划分为 clusterGridSize.xyz 个簇，CPU 每帧把点光源分到覆盖的簇中
+uniform samplerBuffer clusterLightData;      // 每盏灯 2 个 texel：(位置, 半径) (颜色 * 强度, 阴影槽位)
+uniform usamplerBuffer clusterGrid;          // 每簇 (灯光列表起始下标, 灯数)
+uniform usamplerBuffer clusterLightIndices;  // 各簇的灯光列表首尾相接
+
+// 分簇参数（std140，与 UniformBuffers.h 中的 ClusterBlock 一致）
+layout (std140) uniform ClusterBlock {
+    ivec4 clusterGridSize;  // x, y, z 方向的簇数；w 为本帧上传的点光源数
+    vec4 clusterScale;      // xy：gl_FragCoord -> 簇坐标；zw：log(视空间深度) -> 深度切片
+};
 
-// ===== 点光源定义（支持多个灯光） =====
-struct PointLight {
-    vec3 position;   // 世界空间位置
-    vec3 color;      // 光源颜色（强度编码在 color 和 intensity 里）
-    float intensity; // 光强（标量）
+// 每帧数据（std140，与 UniformBuffers.h 中的 FrameBlock 一致，pbr 与 depth 共用）
+layout (std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 camPos;            // 观察者位置（世界空间）
+    float time;
 };
 
-// 预留 8 个点光源位，实际使用数量由 lightCount 控制
-uniform PointLight lights[8];
-uniform int lightCount;  // 当前启用的点光源数量
+// 级联阴影（std140，与 UniformBuffers.h 中的 ShadowBlock 一致，见 ShadowManager.h）
+layout (std140) uniform ShadowBlock {
+    mat4 cascadeMatrices[4];   // 世界空间 -> 各级光源裁剪空间
+    vec4 cascadeSplits;        // 各级覆盖到的视空间深度
+    vec4 cascadeTexelSizes;    // 各级一个 texel 的世界尺寸
+    vec4 cascadeDepthScales;   // 世界单位 -> 各级阴影贴图深度
+    int cascadeCount;
+};
 
-// 观察者位置（世界空间）
-uniform vec3 camPos;
+// 点光源阴影图集（std140，与 UniformBuffers.h 中的 PointShadowBlock 一致，见 PointShadows.h）
+layout (std140) uniform PointShadowBlock {
+    mat4 pointShadowMatrices[48];  // 槽位 * 6 + 面（+X -X +Y -Y +Z -Z）-> 该面的透视裁剪空间
+    vec4 pointShadowAtlasParams;   // xy：一个 tile 的 uv 大小；z：1 / 面分辨率；w：面分辨率
+};
 
 // 材质选项：是否使用GLOSS贴图（需要反转roughness）
 uniform bool useGlossMap;  // true表示roughnessMap实际上是GLOSS贴图，需要反转
 
 // 阴影参数
-uniform float shadowBias;
+uniform float shadowBias;  // 常量偏移（世界单位）
 uniform bool useShadows;  // 是否启用阴影
+uniform int shadowFilter;  // 0 PCF 3x3，1 硬件 4 点，2 泊松 16 点，3 PCSS，4 VSM，5 EVSM（与 ShadowManager.h 中的 ShadowFilter 一致）
+uniform float shadowLightSize;  // PCSS 光源大小：太阳角半径的正切
+uniform float shadowPositiveExponent;  // EVSM 指数（与解析矩时相同）
+uniform float shadowNegativeExponent;
+uniform float shadowLightBleed;   // 漏光削减：切比雪夫上界低于该值视为全暗
+uniform float shadowMinVariance;  // 方差下限（深度² 单位）
 
 const float PI = 3.14159265359;
 
-// PCF软阴影采样函数
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
+// 单位圆内的 16 点泊松盘
+const vec2 POISSON_DISK[16] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379),
+    vec2( 0.44323325, -0.97511554), vec2( 0.53742981, -0.47373420),
+    vec2(-0.26496911, -0.41893023), vec2( 0.79197514,  0.19090188),
+    vec2(-0.24188840,  0.99706507), vec2(-0.81409955,  0.91437590),
+    vec2( 0.19984126,  0.78641367), vec2( 0.14383161, -0.14100790)
+);
+
+// PCSS 遮挡物搜索覆盖的最大遮挡距离（米）和滤波半径上限（texel）
+const float PCSS_SEARCH_DISTANCE = 4.0;
+const float PCSS_MAX_RADIUS = 24.0;
+
+// 按视空间深度选取级联；超出最后一级返回 -1（不在阴影范围内）
+int SelectCascade(float viewDepth)
+{
+    for (int i = 0; i < cascadeCount; ++i) {
+        if (viewDepth < cascadeSplits[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 泊松盘的旋转矩阵：按像素取 interleaved gradient noise 作为角度，相邻像素的采样点互相错开
+mat2 PoissonRotation()
+{
+    float angle = 2.0 * PI * fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    float s = sin(angle);
+    float c = cos(angle);
+    return mat2(c, s, -s, c);
+}
+
+// 原方案：读取 3x3 个 texel 的深度并逐个比较
+float FilterPcf3x3(vec3 coords, float layer, vec2 texelSize, float bias)
+{
+    float shadow = 0.0;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            float pcfDepth = texture(shadowDepthMap, vec3(coords.xy + vec2(x, y) * texelSize, layer)).r;
+            shadow += coords.z - bias > pcfDepth ? 0.0 : 1.0;
+        }
+    }
+    return shadow / 9.0;
+}
+
+// 4 次比较采样，偏移半个 texel：每次硬件比较 2x2 texel 并双线性插值，合起来覆盖 3x3 texel
+float FilterHardware4(vec3 coords, float layer, vec2 texelSize, float bias)
+{
+    float reference = coords.z - bias;
+    float shadow = texture(shadowMap, vec4(coords.xy + vec2(-0.5, -0.5) * texelSize, layer, reference));
+    shadow += texture(shadowMap, vec4(coords.xy + vec2( 0.5, -0.5) * texelSize, layer, reference));
+    shadow += texture(shadowMap, vec4(coords.xy + vec2(-0.5,  0.5) * texelSize, layer, reference));
+    shadow += texture(shadowMap, vec4(coords.xy + vec2( 0.5,  0.5) * texelSize, layer, reference));
+    return shadow * 0.25;
+}
+
+// 半径 radius texel 的旋转泊松盘，16 次比较采样
+// 偏移随半径增大：坡面上离中心 r 个 texel 处的表面深度相差 r * slopeBias
+float FilterPoisson16(vec3 coords, float layer, vec2 texelSize, float bias, float slopeBias, float radius)
+{
+    mat2 rotation = PoissonRotation();
+    float reference = coords.z - bias - slopeBias * radius;
+    float shadow = 0.0;
+    for (int i = 0; i < 16; ++i) {
+        vec2 offset = rotation * POISSON_DISK[i] * radius * texelSize;
+        shadow += texture(shadowMap, vec4(coords.xy + offset, layer, reference));
+    }
+    return shadow / 16.0;
+}
+
+// PCSS：先在最大半影范围内找遮挡物的平均深度，再按 遮挡物到接收面的距离 * 光源大小 决定滤波半径
+// 正交投影下深度与世界距离成正比，texelWorld / depthScale 把半影宽度换算成 texel
+float FilterPcss(vec3 coords, float layer, vec2 texelSize, float bias, float slopeBias, float texelWorld, float depthScale)
+{
+    mat2 rotation = PoissonRotation();
+    float searchRadius = clamp(shadowLightSize * PCSS_SEARCH_DISTANCE / texelWorld, 1.0, PCSS_MAX_RADIUS);
+    float reference = coords.z - bias - slopeBias * searchRadius;
+
+    float blockerDepth = 0.0;
+    float blockers = 0.0;
+    for (int i = 0; i < 16; ++i) {
+        vec2 offset = rotation * POISSON_DISK[i] * searchRadius * texelSize;
+        float depth = texture(shadowDepthMap, vec3(coords.xy + offset, layer)).r;
+        if (depth < reference) {
+            blockerDepth += depth;
+            blockers += 1.0;
+        }
+    }
+    if (blockers == 0.0) {
+        return 1.0;  // 周围没有遮挡物，完全受光
+    }
+    blockerDepth /= blockers;
+
+    float blockerDistance = (coords.z - blockerDepth) / depthScale;
+    float radius = clamp(shadowLightSize * blockerDistance / texelWorld, 1.0, PCSS_MAX_RADIUS);
+    return FilterPoisson16(coords, layer, texelSize, bias, slopeBias, radius);
+}
+
+// 切比雪夫上界：深度分布的均值和方差估计比 depth 更远的比例，再按 shadowLightBleed 削去漏光
+float ChebyshevUpperBound(vec2 moments, float depth, float minVariance)
+{
+    if (depth <= moments.x) {
+        return 1.0;
+    }
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float d = depth - moments.x;
+    float pMax = variance / (variance + d * d);
+    return clamp((pMax - shadowLightBleed) / (1.0 - shadowLightBleed), 0.0, 1.0);
+}
+
+// VSM / EVSM：一次三线性（+ 各向异性）采样得到滤波后的矩
+// 采样位于非一致控制流中（选级、越界返回），隐式导数无定义，mip 层由调用方传入的显式梯度决定
+float FilterMoments(vec3 coords, float layer, float bias, vec2 gradX, vec2 gradY)
+{
+    vec4 moments = textureGrad(shadowMomentMap, vec3(coords.xy, layer), gradX, gradY);
+    float depth = coords.z - bias;
+    if (shadowFilter == 5) {
+        // 与解析时相同的指数变形；方差下限按变形的导数放大
+        float warped = depth * 2.0 - 1.0;
+        float positive = exp(shadowPositiveExponent * warped);
+        float negative = -exp(-shadowNegativeExponent * warped);
+        float positiveScale = 2.0 * shadowPositiveExponent * positive;
+        float negativeScale = 2.0 * shadowNegativeExponent * negative;
+        float positiveLit = ChebyshevUpperBound(moments.xy, positive, shadowMinVariance * positiveScale * positiveScale);
+        float negativeLit = ChebyshevUpperBound(moments.zw, negative, shadowMinVariance * negativeScale * negativeScale);
+        return min(positiveLit, negativeLit);
+    }
+    return ChebyshevUpperBound(moments.xy, depth, shadowMinVariance);
+}
+
+// 方向光阴影：按视空间深度选级，再用 shadowFilter 指定的核过滤（1 为完全受光）
+// dWorldDx / dWorldDy 为世界坐标的屏幕空间导数，须在任何分支之前求出
+float ShadowCalculation(vec3 worldPos, vec3 normal, vec3 lightDir, vec3 dWorldDx, vec3 dWorldDy) {
     if (!useShadows) {
         return 1.0;
     }
 
-    // 执行透视除法
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    
-    // 变换到[0,1]范围
-    projCoords = projCoords * 0.5 + 0.5;
-    
+    int cascade = SelectCascade(ViewDepth);
+    if (cascade < 0) {
+        return 1.0;
+    }
+
+    // 正交投影无需透视除法，直接变换到[0,1]范围
+    vec3 projCoords = (cascadeMatrices[cascade] * vec4(worldPos, 1.0)).xyz * 0.5 + 0.5;
+
     // 检查是否在阴影贴图范围内
-    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 || 
+    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 ||
         projCoords.y < 0.0 || projCoords.y > 1.0) {
         return 1.0;  // 超出范围，不在阴影中
     }
-    
-    // 当前片段在光源空间中的深度
-    float currentDepth = projCoords.z;
-    
-    // 计算阴影偏移（基于法线和光线方向）
-    float bias = max(0.05 * (1.0 - dot(normal, lightDir)), shadowBias);
-    
-    // PCF软阴影：3x3采样
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 0.0 : 1.0;
-        }
+
+    // 阴影偏移：常量 + 按本级 texel 大小和坡度放大，再换算到本级的深度范围
+    float texelWorld = cascadeTexelSizes[cascade];
+    float depthScale = cascadeDepthScales[cascade];
+    float NdotL = max(dot(normal, lightDir), 0.0);
+    float bias = (shadowBias + texelWorld * (1.0 + 2.0 * (1.0 - NdotL))) * depthScale;
+    // 大核的额外偏移：每离开中心一个 texel，坡面深度变化 texel * tan(入射角)
+    float tanTheta = min(sqrt(1.0 - NdotL * NdotL) / max(NdotL, 0.05), 4.0);
+    float slopeBias = texelWorld * tanTheta * depthScale;
+
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float layer = float(cascade);
+    if (shadowFilter == 1) {
+        return FilterHardware4(projCoords, layer, texelSize, bias);
+    } else if (shadowFilter == 2) {
+        return FilterPoisson16(projCoords, layer, texelSize, bias, slopeBias, 2.5);
+    } else if (shadowFilter == 3) {
+        return FilterPcss(projCoords, layer, texelSize, bias, slopeBias, texelWorld, depthScale);
+    } else if (shadowFilter >= 4) {
+        // 正交投影：阴影坐标的导数 = 本级矩阵的线性部分 * 世界坐标的导数，再乘 0.5 映射到 [0,1]
+        mat3 cascadeLinear = mat3(cascadeMatrices[cascade]);
+        vec2 gradX = (cascadeLinear * dWorldDx).xy * 0.5;
+        vec2 gradY = (cascadeLinear * dWorldDy).xy * 0.5;
+        return FilterMoments(projCoords, layer, bias, gradX, gradY);
     }
-    shadow /= 9.0;
-    
-    return shadow;
+    return FilterPcf3x3(projCoords, layer, texelSize, bias);
+}
+
+// 点光源阴影：按片元相对灯的主轴选立方体面，在图集中该面的 tile 内做 4 次比较采样（1 为受光）
+float PointShadow(int slot, vec3 lightPos, vec3 normal)
+{
+    // 法线偏移（90° 视角下距离 d 处一个 texel 宽 2d / 面分辨率）+ 朝向灯的常量偏移，透视深度不必再加偏移
+    vec3 fromLight = WorldPos - lightPos;
+    float distance = length(fromLight);
+    float texelWorld = 2.0 * distance * pointShadowAtlasParams.z;
+    vec3 samplePos = WorldPos + normal * texelWorld * 1.5 - fromLight / max(distance, 1e-4) * shadowBias;
+
+    vec3 v = samplePos - lightPos;
+    vec3 a = abs(v);
+    int face;
+    if (a.x >= a.y && a.x >= a.z) {
+        face = v.x > 0.0 ? 0 : 1;
+    } else if (a.y >= a.z) {
+        face = v.y > 0.0 ? 2 : 3;
+    } else {
+        face = v.z > 0.0 ? 4 : 5;
+    }
+
+    vec4 clip = pointShadowMatrices[slot * 6 + face] * vec4(samplePos, 1.0);
+    vec3 coords = clip.xyz / clip.w * 0.5 + 0.5;
+    if (coords.z > 1.0) {
+        return 1.0;  // 超出影响半径（远平面）
+    }
+
+    // tile 之间没有边框：采样点限制在 tile 内一个 texel 以外，4 次双线性采样都不会读到相邻的面
+    float inset = pointShadowAtlasParams.z;
+    vec2 local = clamp(coords.xy, vec2(inset), vec2(1.0 - inset));
+    vec2 uv = (vec2(float(face), float(slot)) + local) * pointShadowAtlasParams.xy;
+    vec2 texelSize = inset * pointShadowAtlasParams.xy;
+    float shadow = texture(pointShadowAtlas, vec3(uv + vec2(-0.5, -0.5) * texelSize, coords.z));
+    shadow += texture(pointShadowAtlas, vec3(uv + vec2( 0.5, -0.5) * texelSize, coords.z));
+    shadow += texture(pointShadowAtlas, vec3(uv + vec2(-0.5,  0.5) * texelSize, coords.z));
+    shadow += texture(pointShadowAtlas, vec3(uv + vec2( 0.5,  0.5) * texelSize, coords.z));
+    return shadow * 0.25;
 }
 
 // ===== Cook-Torrance BRDF 相关函数 =====
@@ -127,8 +347,46 @@ vec3 fresnelSchlick(float cosTheta, vec3 F0)
     return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
 }
 
+// 单个光源的 Cook-Torrance 贡献（radiance 已含颜色、强度和衰减）
+vec3 EvaluateLight(vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 albedo, float metallic, float rough, vec3 F0)
+{
+    vec3 H = normalize(V + L);
+
+    float NDF = DistributionGGX(N, H, rough);
+    float G   = GeometrySmith(N, V, L, rough);
+    vec3  F   = fresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 kS = F;                        // 镜面部分
+    vec3 kD = vec3(1.0) - kS;           // 漫反射部分
+    kD *= (1.0 - metallic);             // 金属几乎没有漫反射
+
+    float NdotV = max(dot(N, V), 0.0);
+    float NdotL = max(dot(N, L), 0.0);
+
+    vec3 numerator   = NDF * G * F;
+    float denom      = 4.0 * max(NdotV * NdotL, 0.0001);
+    vec3 specular    = numerator / denom;
+
+    vec3 diffuseBRDF = kD * albedo / PI;
+    return (diffuseBRDF + specular) * radiance * NdotL;
+}
+
+// 当前片元所在簇的下标
+int ClusterIndex()
+{
+    ivec2 tile = ivec2(gl_FragCoord.xy * clusterScale.xy);
+    int slice = int(log(max(ViewDepth, 1e-4)) * clusterScale.z + clusterScale.w);
+    tile = clamp(tile, ivec2(0), clusterGridSize.xy - 1);
+    slice = clamp(slice, 0, clusterGridSize.z - 1);
+    return (slice * clusterGridSize.y + tile.y) * clusterGridSize.x + tile.x;
+}
+
 void main()
 {
+    // 阴影采样用的世界坐标导数：在一致控制流中先求出，之后的分支里才可用于矩贴图的 mip 选择
+    vec3 dWorldDx = dFdx(WorldPos);
+    vec3 dWorldDy = dFdy(WorldPos);
+
     // ===== 从贴图中采样 PBR 材质参数 =====
     // 颜色贴图是 sRGB，需要转到线性空间
     vec3  albedo    = texture(albedoMap,    TexCoords).rgb;
@@ -161,52 +419,36 @@ void main()
     // 防止粗糙度为 0 导致 NDF 发散
     float rough = clamp(roughness, 0.04, 1.0);
 
-    // 计算阴影因子（只对自然光/方向光应用阴影）
-    float shadow = 1.0;
-    if (lightCount > 0) {
-        // 假设最后一个光源（lights[lightCount-1]）是自然光/方向光
-        int sunLightIndex = lightCount - 1;
-        vec3 sunLightDir = normalize(lights[sunLightIndex].position - WorldPos);
-        shadow = ShadowCalculation(FragPosLightSpace, N, sunLightDir);
-    }
+    // 方向光：阴影只来自与它关联的阴影贴图
+    float shadow = sun.shadowMapIndex >= 0 ? ShadowCalculation(WorldPos, N, sun.direction, dWorldDx, dWorldDy) : 1.0;
+    Lo += EvaluateLight(N, V, sun.direction, sun.radiance * shadow, albedo, metallic, rough, F0);
 
-    for (int i = 0; i < lightCount; ++i)
+    // 点光源：只遍历本簇的灯光列表
+    uvec2 cluster = texelFetch(clusterGrid, ClusterIndex()).rg;
+    for (uint i = 0u; i < cluster.y; ++i)
     {
-        // 光照方向
-        vec3 L = normalize(lights[i].position - WorldPos);
-        vec3 H = normalize(V + L);
-
-        // 距离衰减（平方反比）
-        float distance    = length(lights[i].position - WorldPos);
-        float attenuation = 1.0 / max(distance * distance, 0.01);
-        vec3 radiance     = lights[i].color * lights[i].intensity * attenuation;
-
-        // Cook-Torrance BRDF
-        float NDF = DistributionGGX(N, H, rough);
-        float G   = GeometrySmith(N, V, L, rough);
-        vec3  F   = fresnelSchlick(max(dot(H, V), 0.0), F0);
-
-        vec3 kS = F;                        // 镜面部分
-        vec3 kD = vec3(1.0) - kS;           // 漫反射部分
-        kD *= (1.0 - metallic);             // 金属几乎没有漫反射
-
-        float NdotV = max(dot(N, V), 0.0);
-        float NdotL = max(dot(N, L), 0.0);
-
-        vec3 numerator   = NDF * G * F;
-        float denom      = 4.0 * max(NdotV * NdotL, 0.0001);
-        vec3 specular    = numerator / denom;
-
-        // 最终每盏灯的贡献
-        vec3 diffuseBRDF = kD * albedo / PI;
-        vec3 contribution = (diffuseBRDF + specular) * radiance * NdotL;
-
-        // 对自然光应用阴影（最后一个光源）
-        if (i == lightCount - 1) {
-            contribution *= shadow;
+        int light = int(texelFetch(clusterLightIndices, int(cluster.x + i)).r);
+        vec4 positionRadius = texelFetch(clusterLightData, light * 2);
+        vec4 colorShadowSlot = texelFetch(clusterLightData, light * 2 + 1);
+
+        vec3 toLight = positionRadius.xyz - WorldPos;
+        float distanceSq = dot(toLight, toLight);
+        float radiusSq = positionRadius.w * positionRadius.w;
+        if (distanceSq >= radiusSq) continue;
+
+        // 平方反比衰减乘以窗口 (1 - (d/r)^4)^2，到影响半径处平滑降为 0
+        float falloff = distanceSq / radiusSq;
+        float window = clamp(1.0 - falloff * falloff, 0.0, 1.0);
+        float attenuation = window * window / max(distanceSq, 0.01);
+        vec3 radiance = colorShadowSlot.rgb * attenuation;
+
+        // 在阴影图集中有槽位的灯（按屏幕贡献选出）才采样阴影
+        int shadowSlot = int(colorShadowSlot.w);
+        if (useShadows && shadowSlot >= 0) {
+            radiance *= PointShadow(shadowSlot, positionRadius.xyz, N);
         }
 
-        Lo += contribution;
+        Lo += EvaluateLight(N, V, toLight * inversesqrt(max(distanceSq, 1e-8)), radiance, albedo, metallic, rough, F0);
     }
 
     // 简单的环境光（未使用 IBL，仅常数环境 + AO）
@@ -2,30 +2,56 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+// 每实例数据（见 Mesh.h 中的 InstanceData）：模型矩阵和 CPU 预先算好的法线矩阵
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
 
 // 输出到片元着色器的插值数据
 out vec3 WorldPos;      // 世界空间位置
 out vec3 Normal;        // 世界空间法线
 out vec2 TexCoords;     // 纹理坐标（为以后贴图留接口）
-out vec4 FragPosLightSpace;  // 光源空间位置（用于阴影采样）
+out float ViewDepth;    // 视空间深度（正值，用于选取光照簇）
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;  // 光源空间矩阵（用于阴影）
+// 深度预渲染后主 pass 用 GL_EQUAL 测试：gl_Position 的计算必须与 depth.vert 逐位一致
+invariant gl_Position;
+
+// 每帧数据（std140，与 UniformBuffers.h 中的 FrameBlock 一致，pbr 与 depth 共用）
+layout (std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 camPos;            // 观察者位置（世界空间）
+    float time;
+};
+
+// 顶点反量化（Mesh::Draw 设置；浮点顶点时 posScale = 1、posBias = 0、octNormals = false）
+uniform vec3 posScale;
+uniform vec3 posBias;
+uniform bool octNormals;        // 法线为八面体编码（aNormal.xy 为 ±32767 的整数）
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 signNotZero = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signNotZero;
+    }
+    return normalize(n);
+}
 
 void main()
 {
+    vec3 position = aPos * posScale + posBias;
+    vec3 normal = octNormals ? DecodeOctahedral(max(aNormal.xy / 32767.0, vec2(-1.0))) : aNormal;
+
     // 顶点位置变换到世界空间
-    WorldPos = vec3(model * vec4(aPos, 1.0));
+    WorldPos = vec3(aModel * vec4(position, 1.0));
 
     // 法线按模型矩阵的逆转置变换到世界空间
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = aNormalMatrix * normal;
 
     TexCoords = aTexCoords;
 
-    // 计算光源空间位置（用于阴影采样）
-    FragPosLightSpace = lightSpaceMatrix * vec4(WorldPos, 1.0);
+    ViewDepth = -(view * vec4(WorldPos, 1.0)).z;
 
     // 最终裁剪空间位置
     gl_Position = projection * view * vec4(WorldPos, 1.0);
@@ -0,0 +1,20 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aModel;   // 每实例模型矩阵（见 pbr.vert）
+
+// 点光源阴影图集（std140，与 UniformBuffers.h 中的 PointShadowBlock 一致，pbr 与 point_shadow 共用）
+layout (std140) uniform PointShadowBlock {
+    mat4 pointShadowMatrices[48];  // 槽位 * 6 + 面 -> 该面的透视裁剪空间
+    vec4 pointShadowAtlasParams;
+};
+
+uniform int faceIndex;  // 当前渲染的面（PointShadowAtlas::BeginFace 设置）
+
+// 顶点位置反量化（见 pbr.vert）
+uniform vec3 posScale;
+uniform vec3 posBias;
+
+void main()
+{
+    gl_Position = pointShadowMatrices[faceIndex] * aModel * vec4(aPos * posScale + posBias, 1.0);
+}
@@ -1,11 +1,24 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aModel;   // 每实例模型矩阵（见 pbr.vert）
 
-uniform mat4 lightSpaceMatrix;
-uniform mat4 model;
+// 级联阴影（std140，与 UniformBuffers.h 中的 ShadowBlock 一致，pbr 与 shadow 共用）
+layout (std140) uniform ShadowBlock {
+    mat4 cascadeMatrices[4];   // 世界空间 -> 各级光源裁剪空间
+    vec4 cascadeSplits;
+    vec4 cascadeTexelSizes;
+    vec4 cascadeDepthScales;
+    int cascadeCount;
+};
+
+uniform int cascadeIndex;  // 当前渲染的级（ShadowManager::BeginCascade 设置）
+
+// 顶点位置反量化（见 pbr.vert）
+uniform vec3 posScale;
+uniform vec3 posBias;
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    gl_Position = cascadeMatrices[cascadeIndex] * aModel * vec4(aPos * posScale + posBias, 1.0);
 }
 
@@ -0,0 +1,59 @@
+#version 330 core
+out vec4 Moments;
+
+// 把级联阴影的深度解析为 VSM / EVSM 的矩（见 ShadowManager::resolveMoments）
+//  resolvePass 0：每个输出 texel 取 2x2 个深度 texel，分别转成矩后平均，再横向高斯模糊
+//  resolvePass 1：对 pass 0 的结果纵向高斯模糊
+uniform sampler2DArray depthMap;   // 级联深度纹理数组（不比较的采样器）
+uniform sampler2D momentMap;       // pass 0 的输出
+uniform int resolvePass;
+uniform int depthLayer;            // 当前解析的级
+uniform bool evsm;                 // EVSM：正/负指数变形后的两组矩；否则 VSM：(深度, 深度²)
+uniform float positiveExponent;
+uniform float negativeExponent;
+uniform int blurRadius;            // 每侧的采样数（矩 texel）
+
+vec4 ComputeMoments(float depth)
+{
+    if (evsm) {
+        // 深度先映射到 [-1, 1]，正负两侧的指数都不会溢出
+        float warped = depth * 2.0 - 1.0;
+        float positive = exp(positiveExponent * warped);
+        float negative = -exp(-negativeExponent * warped);
+        return vec4(positive, positive * positive, negative, negative * negative);
+    }
+    return vec4(depth, depth * depth, 0.0, 0.0);
+}
+
+vec4 DepthMoments(ivec2 texel)
+{
+    ivec2 base = texel * 2;
+    vec4 moments = ComputeMoments(texelFetch(depthMap, ivec3(base, depthLayer), 0).r);
+    moments += ComputeMoments(texelFetch(depthMap, ivec3(base + ivec2(1, 0), depthLayer), 0).r);
+    moments += ComputeMoments(texelFetch(depthMap, ivec3(base + ivec2(0, 1), depthLayer), 0).r);
+    moments += ComputeMoments(texelFetch(depthMap, ivec3(base + ivec2(1, 1), depthLayer), 0).r);
+    return moments * 0.25;
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    ivec2 size = textureSize(depthMap, 0).xy / 2;
+
+    // 高斯权重：sigma 取半径的一半，半径处权重约为 e^-2
+    float sigma = max(float(blurRadius) * 0.5, 0.5);
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+    for (int i = -blurRadius; i <= blurRadius; ++i) {
+        float weight = exp(-float(i * i) / (2.0 * sigma * sigma));
+        if (resolvePass == 0) {
+            ivec2 sampleTexel = clamp(texel + ivec2(i, 0), ivec2(0), size - 1);
+            sum += DepthMoments(sampleTexel) * weight;
+        } else {
+            ivec2 sampleTexel = clamp(texel + ivec2(0, i), ivec2(0), size - 1);
+            sum += texelFetch(momentMap, sampleTexel, 0) * weight;
+        }
+        weightSum += weight;
+    }
+    Moments = sum / weightSum;
+}
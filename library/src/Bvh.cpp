@@ -0,0 +1,432 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+const int kBinCount = 16;
+const size_t kMaxLeafSize = 4;
+const float kTraversalCost = 1.0f;  // 相对于一次包围盒测试的代价
+const int kMaxStackDepth = 64;
+const int kMaxBuildDepth = kMaxStackDepth - 2;  // 遍历栈最多同时保存 深度 + 1 个节点
+
+// 视锥体测试结果
+enum class Containment { Outside, Intersecting, Inside };
+
+inline float SurfaceArea(const Aabb& box) {
+    const glm::vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+inline Aabb EmptyBounds() {
+    Aabb box;
+    box.min = glm::vec3(std::numeric_limits<float>::max());
+    box.max = glm::vec3(-std::numeric_limits<float>::max());
+    return box;
+}
+
+inline void Grow(Aabb& box, const Aabb& other) {
+    box.min = glm::min(box.min, other.min);
+    box.max = glm::max(box.max, other.max);
+}
+
+inline bool Overlaps(const Aabb& a, const Aabb& b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+inline Aabb NodeBounds(const BvhNode& node) {
+    Aabb box;
+    box.min = node.boundsMin;
+    box.max = node.boundsMax;
+    return box;
+}
+
+Containment TestFrustum(const Frustum& frustum, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    const glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+    Containment result = Containment::Inside;
+    for (const glm::vec4& plane : frustum.planes) {
+        const glm::vec3 normal(plane);
+        const float distance = glm::dot(normal, center) + plane.w;
+        const float radius = glm::dot(glm::abs(normal), extent);
+        if (distance + radius < 0.0f) return Containment::Outside;
+        if (distance - radius < 0.0f) result = Containment::Intersecting;
+    }
+    return result;
+}
+
+glm::vec3 SafeInverse(const glm::vec3& direction) {
+    // 分量为 0 时取极大值，slab 测试中对应的区间为 (-inf, inf) 或空
+    const float huge = std::numeric_limits<float>::max();
+    return glm::vec3(direction.x != 0.0f ? 1.0f / direction.x : huge,
+                     direction.y != 0.0f ? 1.0f / direction.y : huge,
+                     direction.z != 0.0f ? 1.0f / direction.z : huge);
+}
+
+} // namespace
+
+bool IntersectRayAabb(const glm::vec3& origin, const glm::vec3& invDirection, const Aabb& box,
+                      float maxDistance, float& distance) {
+    const glm::vec3 t0 = (box.min - origin) * invDirection;
+    const glm::vec3 t1 = (box.max - origin) * invDirection;
+    const glm::vec3 tNear = glm::min(t0, t1);
+    const glm::vec3 tFar = glm::max(t0, t1);
+    const float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+    if (enter > exit) return false;
+    distance = enter;
+    return true;
+}
+
+void Bvh::Build(const Aabb* boxes, size_t count) {
+    nodes.clear();
+    primitiveBounds.clear();
+    primitiveIds.clear();
+    if (count == 0) return;
+
+    std::vector<BuildItem> items(count);
+    for (size_t i = 0; i < count; ++i) {
+        items[i].bounds = boxes[i];
+        items[i].centroid = (boxes[i].min + boxes[i].max) * 0.5f;
+        items[i].index = static_cast<unsigned int>(i);
+    }
+    // 节点数不超过 2n - 1
+    nodes.reserve(2 * count - 1);
+    buildNode(items, 0, count, 0);
+
+    primitiveBounds.resize(count);
+    primitiveIds.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        primitiveBounds[i] = items[i].bounds;
+        primitiveIds[i] = items[i].index;
+    }
+}
+
+unsigned int Bvh::buildNode(std::vector<BuildItem>& items, size_t first, size_t last, int depth) {
+    const unsigned int nodeIndex = static_cast<unsigned int>(nodes.size());
+    nodes.emplace_back();
+
+    Aabb bounds = EmptyBounds();
+    Aabb centroidBounds = EmptyBounds();
+    for (size_t i = first; i < last; ++i) {
+        Grow(bounds, items[i].bounds);
+        centroidBounds.min = glm::min(centroidBounds.min, items[i].centroid);
+        centroidBounds.max = glm::max(centroidBounds.max, items[i].centroid);
+    }
+    nodes[nodeIndex].boundsMin = bounds.min;
+    nodes[nodeIndex].boundsMax = bounds.max;
+
+    const size_t count = last - first;
+    auto makeLeaf = [&]() {
+        nodes[nodeIndex].rightOrFirst = static_cast<uint32_t>(first);
+        nodes[nodeIndex].count = static_cast<uint32_t>(count);
+        return nodeIndex;
+    };
+    if (count <= kMaxLeafSize || depth >= kMaxBuildDepth) return makeLeaf();
+
+    // 三个轴上分别分箱，取 SAH 代价最小的划分
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis) {
+        const float axisMin = centroidBounds.min[axis];
+        const float axisExtent = centroidBounds.max[axis] - axisMin;
+        if (axisExtent <= 0.0f) continue;
+
+        Aabb binBounds[kBinCount];
+        size_t binCounts[kBinCount] = {};
+        for (Aabb& box : binBounds) box = EmptyBounds();
+        const float scale = kBinCount / axisExtent;
+        for (size_t i = first; i < last; ++i) {
+            const int bin = std::min(kBinCount - 1, static_cast<int>((items[i].centroid[axis] - axisMin) * scale));
+            ++binCounts[bin];
+            Grow(binBounds[bin], items[i].bounds);
+        }
+
+        // 从右向左累计，得到每个划分位置右侧的面积和数量
+        float rightArea[kBinCount];
+        size_t rightCount[kBinCount];
+        Aabb accumulated = EmptyBounds();
+        size_t accumulatedCount = 0;
+        for (int bin = kBinCount - 1; bin > 0; --bin) {
+            accumulatedCount += binCounts[bin];
+            if (binCounts[bin] > 0) Grow(accumulated, binBounds[bin]);
+            rightArea[bin] = accumulatedCount > 0 ? SurfaceArea(accumulated) : 0.0f;
+            rightCount[bin] = accumulatedCount;
+        }
+
+        accumulated = EmptyBounds();
+        accumulatedCount = 0;
+        for (int split = 1; split < kBinCount; ++split) {
+            accumulatedCount += binCounts[split - 1];
+            if (binCounts[split - 1] > 0) Grow(accumulated, binBounds[split - 1]);
+            if (accumulatedCount == 0 || rightCount[split] == 0) continue;
+            const float cost = SurfaceArea(accumulated) * accumulatedCount + rightArea[split] * rightCount[split];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = split;
+            }
+        }
+    }
+
+    // 所有质心重合，或划分不比直接做叶子更省
+    const float parentArea = SurfaceArea(bounds);
+    if (bestAxis < 0 || (parentArea > 0.0f && kTraversalCost + bestCost / parentArea >= static_cast<float>(count))) {
+        return makeLeaf();
+    }
+
+    const float axisMin = centroidBounds.min[bestAxis];
+    const float scale = kBinCount / (centroidBounds.max[bestAxis] - axisMin);
+    auto middle = std::partition(items.begin() + first, items.begin() + last, [&](const BuildItem& item) {
+        const int bin = std::min(kBinCount - 1, static_cast<int>((item.centroid[bestAxis] - axisMin) * scale));
+        return bin < bestSplit;
+    });
+    const size_t split = static_cast<size_t>(middle - items.begin());
+
+    buildNode(items, first, split, depth + 1);
+    const unsigned int right = buildNode(items, split, last, depth + 1);
+    nodes[nodeIndex].rightOrFirst = right;
+    nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+void Bvh::QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& out) const {
+    if (nodes.empty()) return;
+
+    // 栈中下标的最高位表示该子树已确定完全在视锥体内
+    const uint32_t kInsideBit = 0x80000000u;
+    uint32_t stack[kMaxStackDepth];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const uint32_t entry = stack[--top];
+        const bool inside = (entry & kInsideBit) != 0;
+        const BvhNode& node = nodes[entry & ~kInsideBit];
+
+        Containment containment = Containment::Inside;
+        if (!inside) {
+            containment = TestFrustum(frustum, node.boundsMin, node.boundsMax);
+            if (containment == Containment::Outside) continue;
+        }
+        const bool allInside = containment == Containment::Inside;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; ++i) {
+                if (allInside || TestFrustum(frustum, primitiveBounds[i].min, primitiveBounds[i].max) != Containment::Outside) {
+                    out.push_back(primitiveIds[i]);
+                }
+            }
+            continue;
+        }
+        const uint32_t flag = allInside ? kInsideBit : 0u;
+        const uint32_t nodeIndex = entry & ~kInsideBit;
+        stack[top++] = node.rightOrFirst | flag;
+        stack[top++] = (nodeIndex + 1) | flag;
+    }
+}
+
+void Bvh::QueryOverlap(const Aabb& box, std::vector<unsigned int>& out) const {
+    if (nodes.empty()) return;
+
+    uint32_t stack[kMaxStackDepth];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const uint32_t nodeIndex = stack[--top];
+        const BvhNode& node = nodes[nodeIndex];
+        if (!Overlaps(NodeBounds(node), box)) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; ++i) {
+                if (Overlaps(primitiveBounds[i], box)) out.push_back(primitiveIds[i]);
+            }
+            continue;
+        }
+        stack[top++] = node.rightOrFirst;
+        stack[top++] = nodeIndex + 1;
+    }
+}
+
+bool Bvh::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, BvhRayHit& hit) const {
+    if (nodes.empty()) return false;
+
+    const glm::vec3 invDirection = SafeInverse(direction);
+    float closest = maxDistance;
+    bool found = false;
+    float distance = 0.0f;
+    if (!IntersectRayAabb(origin, invDirection, NodeBounds(nodes[0]), closest, distance)) return false;
+
+    uint32_t stack[kMaxStackDepth];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BvhNode& node = nodes[stack[--top]];
+        if (node.count > 0) {
+            for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; ++i) {
+                if (IntersectRayAabb(origin, invDirection, primitiveBounds[i], closest, distance)) {
+                    closest = distance;
+                    hit.primitive = primitiveIds[i];
+                    hit.distance = distance;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // 先访问较近的子节点（后入栈），远的子节点在找到更近的命中后会被剪掉
+        const uint32_t leftIndex = static_cast<uint32_t>(&node - nodes.data()) + 1;
+        const uint32_t rightIndex = node.rightOrFirst;
+        float leftDistance = 0.0f;
+        float rightDistance = 0.0f;
+        const bool hitLeft = IntersectRayAabb(origin, invDirection, NodeBounds(nodes[leftIndex]), closest, leftDistance);
+        const bool hitRight = IntersectRayAabb(origin, invDirection, NodeBounds(nodes[rightIndex]), closest, rightDistance);
+        if (hitLeft && hitRight) {
+            if (leftDistance <= rightDistance) {
+                stack[top++] = rightIndex;
+                stack[top++] = leftIndex;
+            } else {
+                stack[top++] = leftIndex;
+                stack[top++] = rightIndex;
+            }
+        } else if (hitLeft) {
+            stack[top++] = leftIndex;
+        } else if (hitRight) {
+            stack[top++] = rightIndex;
+        }
+    }
+    return found;
+}
+
+bool RunBvhBenchmark(size_t boxCount) {
+    // 与视锥体剔除基准相同的随机分布
+    std::mt19937 rng(12345u);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> height(0.0f, 20.0f);
+    std::uniform_real_distribution<float> size(0.1f, 3.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<Aabb> boxes(boxCount);
+    for (Aabb& box : boxes) {
+        const glm::vec3 center(position(rng), height(rng), position(rng));
+        const glm::vec3 extent(size(rng), size(rng), size(rng));
+        box.min = center - extent;
+        box.max = center + extent;
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto start = Clock::now();
+    Bvh bvh;
+    bvh.Build(boxes.data(), boxes.size());
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    bool match = true;
+
+    // 视锥体查询：相机在场景中转一圈
+    const int kFrustumQueries = 16;
+    std::vector<unsigned int> bvhResult;
+    std::vector<unsigned int> bruteResult;
+    double bvhFrustumMs = 0.0;
+    double bruteFrustumMs = 0.0;
+    size_t frustumVisible = 0;
+    for (int q = 0; q < kFrustumQueries; ++q) {
+        const float angle = q * 6.2831853f / kFrustumQueries;
+        const glm::vec3 eye(0.0f, 5.0f, 0.0f);
+        const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::sin(angle), 0.0f, -std::cos(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+        const Frustum frustum = ExtractFrustum(glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f) * view);
+
+        bvhResult.clear();
+        start = Clock::now();
+        bvh.QueryFrustum(frustum, bvhResult);
+        bvhFrustumMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        bruteResult.clear();
+        start = Clock::now();
+        for (size_t i = 0; i < boxCount; ++i) {
+            if (IsAabbVisible(frustum, boxes[i])) bruteResult.push_back(static_cast<unsigned int>(i));
+        }
+        bruteFrustumMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::sort(bvhResult.begin(), bvhResult.end());
+        match = match && bvhResult == bruteResult;
+        frustumVisible += bruteResult.size();
+    }
+
+    // 射线查询：随机起点和方向
+    const int kRayQueries = 1000;
+    double bvhRayMs = 0.0;
+    double bruteRayMs = 0.0;
+    size_t rayHits = 0;
+    for (int q = 0; q < kRayQueries; ++q) {
+        const glm::vec3 origin(position(rng), height(rng), position(rng));
+        glm::vec3 direction(unit(rng), unit(rng) * 0.2f, unit(rng));
+        direction = glm::normalize(direction);
+        const float maxDistance = 200.0f;
+
+        BvhRayHit hit;
+        start = Clock::now();
+        const bool bvhHit = bvh.Raycast(origin, direction, maxDistance, hit);
+        bvhRayMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        const glm::vec3 invDirection = SafeInverse(direction);
+        bool bruteHit = false;
+        float closest = maxDistance;
+        for (size_t i = 0; i < boxCount; ++i) {
+            float distance = 0.0f;
+            if (IntersectRayAabb(origin, invDirection, boxes[i], closest, distance)) {
+                closest = distance;
+                bruteHit = true;
+            }
+        }
+        bruteRayMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // 距离相同的包围盒可能不同，只比较距离
+        match = match && bvhHit == bruteHit && (!bvhHit || hit.distance == closest);
+        rayHits += bvhHit ? 1 : 0;
+    }
+
+    // 包围盒重叠查询
+    const int kOverlapQueries = 1000;
+    double bvhOverlapMs = 0.0;
+    double bruteOverlapMs = 0.0;
+    for (int q = 0; q < kOverlapQueries; ++q) {
+        const glm::vec3 center(position(rng), height(rng), position(rng));
+        Aabb query;
+        query.min = center - glm::vec3(5.0f);
+        query.max = center + glm::vec3(5.0f);
+
+        bvhResult.clear();
+        start = Clock::now();
+        bvh.QueryOverlap(query, bvhResult);
+        bvhOverlapMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        bruteResult.clear();
+        start = Clock::now();
+        for (size_t i = 0; i < boxCount; ++i) {
+            if (Overlaps(boxes[i], query)) bruteResult.push_back(static_cast<unsigned int>(i));
+        }
+        bruteOverlapMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::sort(bvhResult.begin(), bvhResult.end());
+        match = match && bvhResult == bruteResult;
+    }
+
+    std::cout << "BVH::BENCHMARK: boxes " << boxCount << " | nodes " << bvh.NodeCount()
+              << " | build " << buildMs << " ms" << std::endl;
+    std::cout << "BVH::BENCHMARK: frustum x" << kFrustumQueries << " (avg visible " << frustumVisible / kFrustumQueries
+              << ") | bvh " << bvhFrustumMs << " ms | brute force " << bruteFrustumMs << " ms" << std::endl;
+    std::cout << "BVH::BENCHMARK: ray x" << kRayQueries << " (hits " << rayHits << ") | bvh " << bvhRayMs
+              << " ms | brute force " << bruteRayMs << " ms" << std::endl;
+    std::cout << "BVH::BENCHMARK: overlap x" << kOverlapQueries << " | bvh " << bvhOverlapMs
+              << " ms | brute force " << bruteOverlapMs << " ms"
+              << (match ? "" : " | RESULT MISMATCH") << std::endl;
+    return match;
+}
@@ -0,0 +1,67 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "EntityStore.h"
+#include "FrustumCuller.h"
+
+// 扁平化的 BVH 节点（32 字节，两个节点占一条缓存行）
+// 节点按深度优先顺序存放：内部节点的左子节点紧跟在自身之后，只需记录右子节点下标
+struct BvhNode {
+    glm::vec3 boundsMin;
+    uint32_t rightOrFirst;  // 内部节点：右子节点下标；叶子：第一个图元在 primitives 中的位置
+    glm::vec3 boundsMax;
+    uint32_t count;         // 叶子的图元数；0 表示内部节点
+};
+static_assert(sizeof(BvhNode) == 32, "BvhNode must stay 32 bytes");
+
+struct BvhRayHit {
+    unsigned int primitive = 0;  // 命中的包围盒下标（与 Build 传入的顺序一致）
+    float distance = 0.0f;       // 沿射线方向的距离（射线方向已归一化时为世界单位）
+};
+
+// 静态物体包围盒上的 BVH：分箱 SAH 构建，支持视锥体、射线和包围盒重叠查询
+// 查询结果是 Build 时传入的包围盒下标（对 Scene 来说就是实体下标）
+class Bvh {
+public:
+    // 重新构建（包围盒有变化时调用）
+    void Build(const Aabb* boxes, size_t count);
+
+    size_t PrimitiveCount() const { return primitiveBounds.size(); }
+    size_t NodeCount() const { return nodes.size(); }
+
+    // 把与视锥体相交的包围盒下标追加到 out；完全在视锥体内的子树不再逐个测试
+    void QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& out) const;
+
+    // 把与 box 重叠的包围盒下标追加到 out
+    void QueryOverlap(const Aabb& box, std::vector<unsigned int>& out) const;
+
+    // 求射线在 [0, maxDistance] 内命中的最近包围盒；起点在包围盒内时距离为 0
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, BvhRayHit& hit) const;
+
+private:
+    struct BuildItem {
+        Aabb bounds;
+        glm::vec3 centroid;
+        unsigned int index;
+    };
+
+    unsigned int buildNode(std::vector<BuildItem>& items, size_t first, size_t last, int depth);
+
+    std::vector<BvhNode> nodes;
+    std::vector<Aabb> primitiveBounds;        // 按叶子顺序排列，叶子内的测试顺序访问内存
+    std::vector<unsigned int> primitiveIds;   // 叶子顺序 -> 原始下标
+};
+
+// 射线与包围盒的 slab 测试；invDirection 为方向的分量倒数，命中时返回进入距离（起点在内部时为 0）
+bool IntersectRayAabb(const glm::vec3& origin, const glm::vec3& invDirection, const Aabb& box,
+                      float maxDistance, float& distance);
+
+// 无窗口基准测试：boxCount 个随机包围盒上比较 BVH 与暴力遍历的视锥体/射线/重叠查询
+// 结果不一致时返回 false（main 中通过 --bench-bvh 调用）
+bool RunBvhBenchmark(size_t boxCount);
+
+#endif // BVH_H
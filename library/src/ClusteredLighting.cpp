@@ -0,0 +1,282 @@
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+// texture buffer 的格式，与 buffers / textures 的顺序一致
+const GLenum kBufferFormats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+
+// 球在一个坐标轴上的投影范围：在相机空间 (x, 深度) 平面内求两条过原点的切线，结果为 NDC
+// scale 为投影矩阵对应轴的缩放（projection[0][0] 或 [1][1]）
+// 相机在球内或切线越过 90° 时取到屏幕边缘；范围与屏幕不相交时返回 false
+bool ProjectSphereAxis(float x, float depth, float radius, float scale, float& ndcMin, float& ndcMax) {
+    ndcMin = -1.0f;
+    ndcMax = 1.0f;
+    const float tangentSq = x * x + depth * depth - radius * radius;
+    if (tangentSq <= 0.0f) return true;
+
+    const float tangent = std::sqrt(tangentSq);
+    const float minDenom = depth * tangent + x * radius;
+    const float maxDenom = depth * tangent - x * radius;
+    if (minDenom > 0.0f) ndcMin = (x * tangent - radius * depth) / minDenom * scale;
+    if (maxDenom > 0.0f) ndcMax = (x * tangent + radius * depth) / maxDenom * scale;
+    if (ndcMin > 1.0f || ndcMax < -1.0f || ndcMin > ndcMax) return false;
+    ndcMin = std::max(ndcMin, -1.0f);
+    ndcMax = std::min(ndcMax, 1.0f);
+    return true;
+}
+
+// NDC 坐标 -> 屏幕分块下标
+inline int Tile(float ndc, int count) {
+    return std::min(std::max(static_cast<int>((ndc * 0.5f + 0.5f) * count), 0), count - 1);
+}
+
+inline size_t ClusterIndex(int x, int y, int z) {
+    return (static_cast<size_t>(z) * kClusterGridY + y) * kClusterGridX + x;
+}
+
+void UploadTextureBuffer(GLuint buffer, const void* data, size_t bytes) {
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, bytes, data, GL_STREAM_DRAW);
+}
+
+} // namespace
+
+float ComputeLightRadius(const PointLight& light) {
+    const float peak = std::max(light.color.r, std::max(light.color.g, light.color.b)) * light.intensity;
+    return peak > 0.0f ? std::sqrt(peak / kLightCutoffRadiance) : 0.0f;
+}
+
+ClusteredLights::~ClusteredLights() {
+    Cleanup();
+}
+
+void ClusteredLights::Initialize() {
+    Cleanup();
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+    for (int i = 0; i < 3; ++i) {
+        // 先分配一个元素，纹理不会引用空缓冲
+        UploadTextureBuffer(buffers[i], nullptr, sizeof(glm::vec4));
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, kBufferFormats[i], buffers[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    clusterUniforms.Initialize(kClusterBlockBinding, sizeof(ClusterBlock));
+}
+
+void ClusteredLights::Cleanup() {
+    if (textures[0] != 0) {
+        glDeleteTextures(3, textures);
+        textures[0] = textures[1] = textures[2] = 0;
+    }
+    if (buffers[0] != 0) {
+        glDeleteBuffers(3, buffers);
+        buffers[0] = buffers[1] = buffers[2] = 0;
+    }
+    clusterUniforms.Cleanup();
+}
+
+int ClusteredLights::DepthSlice(float viewDepth) const {
+    const int slice = static_cast<int>(std::log(viewDepth) * sliceScale + sliceBias);
+    return std::min(std::max(slice, 0), kClusterGridZ - 1);
+}
+
+void ClusteredLights::Bin(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+                          const std::vector<int>* shadowSlots) {
+    using Clock = std::chrono::high_resolution_clock;
+    const auto start = Clock::now();
+
+    // 近/远平面从透视投影矩阵反推
+    const float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    const float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    const float logRange = std::log(farPlane / nearPlane);
+    sliceScale = kClusterGridZ / logRange;
+    sliceBias = -kClusterGridZ * std::log(nearPlane) / logRange;
+
+    // 1. 每盏灯覆盖的簇范围；不在视锥体内的灯直接跳过，其余按紧凑下标写入 lightData
+    ranges.clear();
+    sourceLights.clear();
+    lightData.clear();
+    for (size_t i = 0; i < lights.size(); ++i) {
+        const PointLight& light = lights[i];
+        const float radius = ComputeLightRadius(light);
+        if (radius <= 0.0f) continue;
+
+        const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        const float depth = -center.z;
+        if (depth + radius < nearPlane || depth - radius > farPlane) continue;
+
+        float xMin, xMax, yMin, yMax;
+        if (!ProjectSphereAxis(center.x, depth, radius, projection[0][0], xMin, xMax)) continue;
+        if (!ProjectSphereAxis(center.y, depth, radius, projection[1][1], yMin, yMax)) continue;
+
+        LightRange range;
+        range.light = static_cast<uint32_t>(sourceLights.size());
+        range.minX = static_cast<uint16_t>(Tile(xMin, kClusterGridX));
+        range.maxX = static_cast<uint16_t>(Tile(xMax, kClusterGridX));
+        range.minY = static_cast<uint16_t>(Tile(yMin, kClusterGridY));
+        range.maxY = static_cast<uint16_t>(Tile(yMax, kClusterGridY));
+        range.minZ = static_cast<uint16_t>(DepthSlice(std::max(depth - radius, nearPlane)));
+        range.maxZ = static_cast<uint16_t>(DepthSlice(std::min(depth + radius, farPlane)));
+        ranges.push_back(range);
+
+        sourceLights.push_back(static_cast<uint32_t>(i));
+        lightData.push_back(glm::vec4(light.position, radius));
+        const int shadowSlot = shadowSlots != nullptr ? (*shadowSlots)[i] : -1;
+        lightData.push_back(glm::vec4(light.color * light.intensity, static_cast<float>(shadowSlot)));
+    }
+
+    // 2. 每簇计数，前缀和得到各簇列表的起始位置
+    clusterCounts.assign(kClusterCount, 0);
+    for (const LightRange& range : ranges) {
+        for (int z = range.minZ; z <= range.maxZ; ++z) {
+            for (int y = range.minY; y <= range.maxY; ++y) {
+                for (int x = range.minX; x <= range.maxX; ++x) ++clusterCounts[ClusterIndex(x, y, z)];
+            }
+        }
+    }
+    clusterGrid.resize(kClusterCount * 2);
+    uint32_t offset = 0;
+    stats.occupiedClusters = 0;
+    stats.maxClusterLights = 0;
+    for (size_t cluster = 0; cluster < static_cast<size_t>(kClusterCount); ++cluster) {
+        const uint32_t count = clusterCounts[cluster];
+        clusterGrid[cluster * 2] = offset;
+        clusterGrid[cluster * 2 + 1] = count;
+        clusterCounts[cluster] = offset;  // 之后作为填充游标
+        offset += count;
+        if (count > 0) ++stats.occupiedClusters;
+        stats.maxClusterLights = std::max(stats.maxClusterLights, count);
+    }
+
+    // 3. 填充灯光下标（同一簇内按灯光顺序排列）
+    lightIndices.resize(offset);
+    for (const LightRange& range : ranges) {
+        for (int z = range.minZ; z <= range.maxZ; ++z) {
+            for (int y = range.minY; y <= range.maxY; ++y) {
+                for (int x = range.minX; x <= range.maxX; ++x) {
+                    lightIndices[clusterCounts[ClusterIndex(x, y, z)]++] = range.light;
+                }
+            }
+        }
+    }
+
+    stats.lights = static_cast<unsigned int>(lights.size());
+    stats.visibleLights = static_cast<unsigned int>(sourceLights.size());
+    stats.lightIndices = offset;
+    stats.binningMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void ClusteredLights::Update(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+                             int viewportWidth, int viewportHeight, const std::vector<int>* shadowSlots) {
+    Bin(lights, view, projection, shadowSlots);
+    if (buffers[0] == 0) return;
+
+    // 没有可见灯光时也至少上传一个元素（纹理不引用空缓冲；着色器不会读到它）
+    if (lightData.empty()) lightData.resize(2, glm::vec4(0.0f));
+    if (lightIndices.empty()) lightIndices.push_back(0);
+    UploadTextureBuffer(buffers[0], lightData.data(), lightData.size() * sizeof(glm::vec4));
+    UploadTextureBuffer(buffers[1], clusterGrid.data(), clusterGrid.size() * sizeof(uint32_t));
+    UploadTextureBuffer(buffers[2], lightIndices.data(), lightIndices.size() * sizeof(uint32_t));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    ClusterBlock block{};
+    block.gridSize = glm::ivec4(kClusterGridX, kClusterGridY, kClusterGridZ, static_cast<int>(stats.visibleLights));
+    block.clusterScale = glm::vec4(static_cast<float>(kClusterGridX) / std::max(viewportWidth, 1),
+                                   static_cast<float>(kClusterGridY) / std::max(viewportHeight, 1),
+                                   sliceScale, sliceBias);
+    clusterUniforms.Update(block);
+}
+
+void ClusteredLights::Bind(unsigned int firstUnit) const {
+    for (unsigned int i = 0; i < 3; ++i) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+    }
+}
+
+void ClusteredLights::GetClusterLights(int x, int y, int z, std::vector<unsigned int>& out) const {
+    out.clear();
+    if (clusterGrid.empty()) return;
+    const size_t cluster = ClusterIndex(x, y, z);
+    const uint32_t first = clusterGrid[cluster * 2];
+    const uint32_t count = clusterGrid[cluster * 2 + 1];
+    for (uint32_t i = 0; i < count; ++i) out.push_back(sourceLights[lightIndices[first + i]]);
+}
+
+bool RunClusterBinningBenchmark(size_t lightCount) {
+    // 128 x 64 米的阅览大厅，灯挂在 2-5 米高处
+    std::mt19937 rng(12345u);
+    std::uniform_real_distribution<float> hallX(-64.0f, 64.0f);
+    std::uniform_real_distribution<float> hallZ(-32.0f, 32.0f);
+    std::uniform_real_distribution<float> height(2.0f, 5.0f);
+    std::uniform_real_distribution<float> warmth(0.8f, 1.0f);
+    std::uniform_real_distribution<float> intensity(1.0f, 4.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<PointLight> lights(lightCount);
+    for (PointLight& light : lights) {
+        light.position = glm::vec3(hallX(rng), height(rng), hallZ(rng));
+        light.color = glm::vec3(1.0f, warmth(rng), warmth(rng) * 0.9f);
+        light.intensity = intensity(rng);
+    }
+
+    const float nearPlane = 0.1f;
+    const float farPlane = 100.0f;
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, nearPlane, farPlane);
+
+    // 相机在大厅中央原地转一圈；每帧用随机采样点检查簇列表是否包含所有影响该点的灯
+    const int kFrames = 64;
+    const int kSamplesPerFrame = 256;
+    ClusteredLights clusters;
+    std::vector<unsigned int> clusterLights;
+    double binningMs = 0.0;
+    double maxBinningMs = 0.0;
+    size_t visibleLights = 0;
+    size_t indices = 0;
+    size_t missing = 0;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        const float angle = frame * 6.2831853f / kFrames;
+        const glm::vec3 eye(0.0f, 1.7f, 0.0f);
+        const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::sin(angle), -0.1f, -std::cos(angle)),
+                                           glm::vec3(0.0f, 1.0f, 0.0f));
+        clusters.Bin(lights, view, projection);
+        const ClusterStats& stats = clusters.GetStats();
+        binningMs += stats.binningMs;
+        maxBinningMs = std::max(maxBinningMs, stats.binningMs);
+        visibleLights += stats.visibleLights;
+        indices += stats.lightIndices;
+
+        const glm::mat4 inverseView = glm::inverse(view);
+        for (int s = 0; s < kSamplesPerFrame; ++s) {
+            const float ndcX = unit(rng) * 2.0f - 1.0f;
+            const float ndcY = unit(rng) * 2.0f - 1.0f;
+            const float depth = nearPlane * std::pow(farPlane / nearPlane, unit(rng));
+            const glm::vec3 viewPos(ndcX * depth / projection[0][0], ndcY * depth / projection[1][1], -depth);
+            const glm::vec3 worldPos = glm::vec3(inverseView * glm::vec4(viewPos, 1.0f));
+
+            clusters.GetClusterLights(Tile(ndcX, kClusterGridX), Tile(ndcY, kClusterGridY),
+                                      clusters.DepthSlice(depth), clusterLights);
+            for (size_t i = 0; i < lights.size(); ++i) {
+                if (glm::length(lights[i].position - worldPos) >= ComputeLightRadius(lights[i])) continue;
+                if (std::find(clusterLights.begin(), clusterLights.end(), i) == clusterLights.end()) ++missing;
+            }
+        }
+    }
+
+    std::cout << "CLUSTERED_LIGHTING::BENCHMARK: lights " << lightCount << " | clusters " << kClusterCount
+              << " | frames " << kFrames << " | binning avg " << binningMs / kFrames << " ms (max "
+              << maxBinningMs << " ms)" << std::endl;
+    std::cout << "CLUSTERED_LIGHTING::BENCHMARK: avg visible lights " << visibleLights / kFrames
+              << " | avg light indices " << indices / kFrames
+              << " | samples " << kFrames * kSamplesPerFrame
+              << (missing == 0 ? "" : " | MISSING LIGHTS IN CLUSTERS") << std::endl;
+    return missing == 0;
+}
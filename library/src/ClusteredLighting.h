@@ -0,0 +1,107 @@
+#ifndef CLUSTERED_LIGHTING_H
+#define CLUSTERED_LIGHTING_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "UniformBuffers.h"
+
+// 点光源（世界空间），来自场景文件的 light 行
+struct PointLight {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+};
+
+// 平方反比衰减下辐亮度（颜色最大分量 * 强度 / 距离²）降到该值时视为不再有贡献
+const float kLightCutoffRadiance = 0.05f;
+
+// 点光源的影响半径：辐亮度降到 kLightCutoffRadiance 的距离
+// 着色器在半径内乘以平滑窗口 (1 - (d/r)^4)^2，半径处恰好衰减到 0，不会出现亮度断层
+float ComputeLightRadius(const PointLight& light);
+
+// 相机视锥体划分为 16 x 9 x 24 个簇（froxel）：屏幕按 NDC 均匀分块，深度按对数切片
+const int kClusterGridX = 16;
+const int kClusterGridY = 9;
+const int kClusterGridZ = 24;
+const int kClusterCount = kClusterGridX * kClusterGridY * kClusterGridZ;
+
+struct ClusterStats {
+    unsigned int lights = 0;             // 场景中的点光源数
+    unsigned int visibleLights = 0;      // 至少落入一个簇的点光源数（只上传这些）
+    unsigned int lightIndices = 0;       // 所有簇的灯光列表总长度
+    unsigned int occupiedClusters = 0;   // 灯光列表非空的簇数
+    unsigned int maxClusterLights = 0;   // 单个簇的最长灯光列表
+    double binningMs = 0.0;              // CPU 分簇耗时
+};
+
+// 分簇前向光照
+//  1. CPU 上把每盏灯的包围球投影到屏幕（切线求出精确的 NDC 范围）并按深度求出切片范围，
+//     加入覆盖到的所有簇（保守，不逐簇做球与簇的精确测试）
+//  2. 计数、前缀和、填充三步得到紧凑的灯光下标列表
+//  3. 灯光数据、每簇 (起始下标, 灯数)、灯光下标分别写入三个 texture buffer，每帧整块重新上传
+//     灯光数据带上阴影图集的槽位（见 PointShadows.h），着色器据此决定是否采样点光源阴影
+// 片元着色器由 gl_FragCoord 和视空间深度算出所在簇，只遍历该簇的灯光
+class ClusteredLights {
+public:
+    ClusteredLights() = default;
+    ~ClusteredLights();
+    ClusteredLights(const ClusteredLights&) = delete;
+    ClusteredLights& operator=(const ClusteredLights&) = delete;
+
+    // 创建 texture buffer 和 ClusterBlock 的 uniform 缓冲
+    void Initialize();
+    void Cleanup();
+
+    // 只做 CPU 分簇（基准测试直接调用）；projection 必须是透视投影
+    // shadowSlots：每盏灯在阴影图集中的槽位（-1 为无阴影），为空指针时都不投射阴影
+    void Bin(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+             const std::vector<int>* shadowSlots = nullptr);
+
+    // 分簇并上传；viewport 尺寸用于把 gl_FragCoord 换算成簇坐标
+    void Update(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+                int viewportWidth, int viewportHeight, const std::vector<int>* shadowSlots = nullptr);
+
+    // 把三个 texture buffer 绑定到 firstUnit 起的连续三个纹理单元
+    void Bind(unsigned int firstUnit) const;
+
+    const ClusterStats& GetStats() const { return stats; }
+
+    // 簇 (x, y, z) 的灯光列表（下标指向 Bin 传入的灯光数组）
+    void GetClusterLights(int x, int y, int z, std::vector<unsigned int>& out) const;
+
+    // 视空间深度（正值）所在的深度切片
+    int DepthSlice(float viewDepth) const;
+
+private:
+    // 一盏灯覆盖的簇范围（闭区间）
+    struct LightRange {
+        uint32_t light;
+        uint16_t minX, maxX, minY, maxY, minZ, maxZ;
+    };
+
+    std::vector<LightRange> ranges;
+    std::vector<uint32_t> clusterCounts;
+    std::vector<uint32_t> clusterGrid;      // 每簇 (起始下标, 灯数)
+    std::vector<uint32_t> lightIndices;     // 指向 lightData 中的紧凑下标
+    std::vector<uint32_t> sourceLights;     // 紧凑下标 -> Bin 传入的灯光下标
+    std::vector<glm::vec4> lightData;       // 每盏灯 2 个 texel：(位置, 半径) (颜色 * 强度, 阴影槽位)
+
+    float sliceScale = 0.0f;                // 切片 = log(深度) * sliceScale + sliceBias
+    float sliceBias = 0.0f;
+
+    // 三个 texture buffer：灯光数据、每簇列表范围、灯光下标
+    GLuint buffers[3] = { 0, 0, 0 };
+    GLuint textures[3] = { 0, 0, 0 };
+    UniformBuffer clusterUniforms;
+
+    ClusterStats stats;
+};
+
+// 无窗口基准测试：随机分布的 lightCount 盏灯在相机转动时逐帧分簇，
+// 输出平均耗时，并用随机采样点检查簇列表没有遗漏影响该点的灯
+bool RunClusterBinningBenchmark(size_t lightCount);
+
+#endif // CLUSTERED_LIGHTING_H
@@ -0,0 +1,87 @@
+#include "EntityStore.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+Aabb TransformAabb(const Aabb& box, const glm::mat4& matrix) {
+    const glm::vec3 center = (box.min + box.max) * 0.5f;
+    const glm::vec3 extent = (box.max - box.min) * 0.5f;
+
+    // 新半长 = |M3x3| * 原半长
+    const glm::vec3 worldCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+    glm::vec3 worldExtent(0.0f);
+    for (int column = 0; column < 3; ++column) {
+        worldExtent += glm::abs(glm::vec3(matrix[column])) * extent[column];
+    }
+
+    Aabb result;
+    result.min = worldCenter - worldExtent;
+    result.max = worldCenter + worldExtent;
+    return result;
+}
+
+unsigned int EntityStore::Create(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale,
+                                 const Aabb& bounds, uint8_t entityFlags,
+                                 const EntityDrawable* entityDrawables, size_t drawableCount) {
+    const unsigned int entity = static_cast<unsigned int>(worldMatrices.size());
+    positions.push_back(position);
+    rotations.push_back(rotation);
+    scales.push_back(scale);
+    localBounds.push_back(bounds);
+
+    worldMatrices.emplace_back(1.0f);
+    normalMatrices.emplace_back(1.0f);
+    worldBounds.push_back(bounds);
+
+    flags.push_back(entityFlags);
+    dirty.push_back(1);
+    dirtyList.push_back(entity);
+
+    firstDrawable.push_back(static_cast<unsigned int>(drawables.size()));
+    drawableCounts.push_back(static_cast<unsigned int>(drawableCount));
+    drawables.insert(drawables.end(), entityDrawables, entityDrawables + drawableCount);
+    return entity;
+}
+
+void EntityStore::Clear() {
+    *this = EntityStore();
+}
+
+void EntityStore::SetTransform(unsigned int entity, const glm::vec3& position, const glm::vec3& rotation,
+                               const glm::vec3& scale) {
+    positions[entity] = position;
+    rotations[entity] = rotation;
+    scales[entity] = scale;
+    if (!dirty[entity]) {
+        dirty[entity] = 1;
+        dirtyList.push_back(entity);
+    }
+}
+
+size_t EntityStore::UpdateTransforms() {
+    const size_t updated = dirtyList.size();
+    for (unsigned int entity : dirtyList) {
+        const glm::vec3& rotation = rotations[entity];
+        glm::mat4 world = glm::translate(glm::mat4(1.0f), positions[entity]);
+        world = glm::rotate(world, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        world = glm::rotate(world, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        world = glm::rotate(world, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        world = glm::scale(world, scales[entity]);
+
+        worldMatrices[entity] = world;
+        normalMatrices[entity] = glm::transpose(glm::inverse(glm::mat3(world)));
+        worldBounds[entity] = TransformAabb(localBounds[entity], world);
+        dirty[entity] = 0;
+    }
+    dirtyList.clear();
+    return updated;
+}
+
+Aabb EntityStore::GetSceneBounds() const {
+    if (worldBounds.empty()) return Aabb();
+    Aabb result = worldBounds[0];
+    for (const Aabb& box : worldBounds) {
+        result.min = glm::min(result.min, box.min);
+        result.max = glm::max(result.max, box.max);
+    }
+    return result;
+}
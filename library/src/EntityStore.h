@@ -0,0 +1,84 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+#include "Texture.h"
+
+// 轴对齐包围盒
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+};
+
+// 把局部包围盒变换到 matrix 所在空间（取变换后 8 个角点的包围盒，按中心/半长计算）
+Aabb TransformAabb(const Aabb& box, const glm::mat4& matrix);
+
+// 实体的一个绘制部件：网格 + 材质（材质为 nullptr 时只参与不需要材质的通道）
+struct EntityDrawable {
+    Mesh* mesh;
+    const PBRTextureMaterial* material;
+};
+
+enum EntityFlags : uint8_t {
+    kEntityCastShadow = 1 << 0,
+    kEntityUseGloss = 1 << 1,   // roughnessMap 为 GLOSS 贴图
+    kEntityOccluder = 1 << 2,   // 写入遮挡剔除的深度缓冲
+};
+
+// 静态物体的 SoA 存储：局部变换、缓存的世界矩阵/法线矩阵/世界包围盒分别存放在连续数组中
+// 渲染和阴影通道按下标遍历同一组数组；矩阵只在变换被修改（dirty）后重新计算
+class EntityStore {
+public:
+    // 添加实体，drawables 复制到共享部件数组；返回实体下标（创建时即标记为 dirty）
+    // rotation 为角度，世界矩阵 = T * Ry * Rx * Rz * S（与场景文件一致）
+    unsigned int Create(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale,
+                        const Aabb& localBounds, uint8_t flags,
+                        const EntityDrawable* drawables, size_t drawableCount);
+
+    void Clear();
+
+    // 修改局部变换并标记 dirty（下一次 UpdateTransforms 时重新计算）
+    void SetTransform(unsigned int entity, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+
+    // 重新计算所有 dirty 实体的世界矩阵、法线矩阵和世界包围盒；返回更新的实体数
+    size_t UpdateTransforms();
+
+    size_t Count() const { return worldMatrices.size(); }
+    const glm::mat4& GetWorldMatrix(unsigned int entity) const { return worldMatrices[entity]; }
+    const glm::mat3& GetNormalMatrix(unsigned int entity) const { return normalMatrices[entity]; }
+    const Aabb& GetWorldBounds(unsigned int entity) const { return worldBounds[entity]; }
+    const Aabb* GetWorldBoundsData() const { return worldBounds.data(); }
+    uint8_t GetFlags(unsigned int entity) const { return flags[entity]; }
+
+    // 实体的绘制部件为 drawables[first, first + count)
+    const EntityDrawable* GetDrawables(unsigned int entity) const { return drawables.data() + firstDrawable[entity]; }
+    unsigned int GetDrawableCount(unsigned int entity) const { return drawableCounts[entity]; }
+
+    // 所有实体世界包围盒的并集
+    Aabb GetSceneBounds() const;
+
+private:
+    // 局部变换
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<Aabb> localBounds;
+
+    // 缓存的世界空间数据
+    std::vector<glm::mat4> worldMatrices;
+    std::vector<glm::mat3> normalMatrices;
+    std::vector<Aabb> worldBounds;
+
+    std::vector<uint8_t> flags;
+    std::vector<uint8_t> dirty;
+    std::vector<unsigned int> dirtyList;  // dirty 实体的下标，UpdateTransforms 只处理这些
+
+    std::vector<unsigned int> firstDrawable;
+    std::vector<unsigned int> drawableCounts;
+    std::vector<EntityDrawable> drawables;
+};
+
+#endif // ENTITY_STORE_H
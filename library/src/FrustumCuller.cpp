@@ -0,0 +1,183 @@
+#include "FrustumCuller.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_CULLER_SSE 1
+#include <xmmintrin.h>
+#endif
+
+Frustum ExtractFrustum(const glm::mat4& m) {
+    // glm 为列主序：m[c][r]，取第 r 行
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0;  // 左
+    frustum.planes[1] = row3 - row0;  // 右
+    frustum.planes[2] = row3 + row1;  // 下
+    frustum.planes[3] = row3 - row1;  // 上
+    frustum.planes[4] = row3 + row2;  // 近
+    frustum.planes[5] = row3 - row2;  // 远
+    for (glm::vec4& plane : frustum.planes) {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+    return frustum;
+}
+
+bool IsAabbVisible(const Frustum& frustum, const Aabb& box) {
+    const glm::vec3 center = (box.min + box.max) * 0.5f;
+    const glm::vec3 extent = (box.max - box.min) * 0.5f;
+    for (const glm::vec4& plane : frustum.planes) {
+        const glm::vec3 normal(plane);
+        // 包围盒在法线方向上的投影半径
+        // 求和顺序与 FrustumCuller 的标量/SSE 路径相同，位于平面上的包围盒三者判定一致
+        const float radius = (std::fabs(normal.x) * extent.x + std::fabs(normal.y) * extent.y) + std::fabs(normal.z) * extent.z;
+        const float distance = (normal.x * center.x + normal.y * center.y) + (normal.z * center.z + plane.w);
+        if (distance + radius < 0.0f) return false;
+    }
+    return true;
+}
+
+void FrustumCuller::SetBounds(const Aabb* boxes, size_t boxCount) {
+    count = boxCount;
+    const size_t padded = (boxCount + 3) & ~size_t(3);
+    std::vector<float>* arrays[6] = { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ };
+    for (std::vector<float>* array : arrays) array->assign(padded, 0.0f);
+    for (size_t i = boxCount; i < padded; ++i) {
+        extentX[i] = extentY[i] = extentZ[i] = -1.0e30f;
+    }
+    for (size_t i = 0; i < boxCount; ++i) {
+        const glm::vec3 center = (boxes[i].min + boxes[i].max) * 0.5f;
+        const glm::vec3 extent = (boxes[i].max - boxes[i].min) * 0.5f;
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+        extentX[i] = extent.x;
+        extentY[i] = extent.y;
+        extentZ[i] = extent.z;
+    }
+}
+
+size_t FrustumCuller::CullScalar(const Frustum& frustum, std::vector<unsigned int>& visible) const {
+    visible.clear();
+    for (size_t i = 0; i < count; ++i) {
+        bool inside = true;
+        for (const glm::vec4& plane : frustum.planes) {
+            // 与 SSE 路径的各通道相同的求和顺序：(x*nx + y*ny) + (z*nz + d)，保证两条路径结果逐位一致
+            const float distance = (plane.x * centerX[i] + plane.y * centerY[i]) + (plane.z * centerZ[i] + plane.w);
+            const float radius = (std::fabs(plane.x) * extentX[i] + std::fabs(plane.y) * extentY[i]) +
+                                 std::fabs(plane.z) * extentZ[i];
+            if (distance + radius < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) visible.push_back(static_cast<unsigned int>(i));
+    }
+    return visible.size();
+}
+
+size_t FrustumCuller::Cull(const Frustum& frustum, std::vector<unsigned int>& visible) const {
+#ifdef FRUSTUM_CULLER_SSE
+    visible.clear();
+    // 每个平面的系数广播到 4 个通道；|n| 预先取好
+    __m128 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& plane = frustum.planes[p];
+        nx[p] = _mm_set1_ps(plane.x);
+        ny[p] = _mm_set1_ps(plane.y);
+        nz[p] = _mm_set1_ps(plane.z);
+        nw[p] = _mm_set1_ps(plane.w);
+        ax[p] = _mm_set1_ps(std::fabs(plane.x));
+        ay[p] = _mm_set1_ps(std::fabs(plane.y));
+        az[p] = _mm_set1_ps(std::fabs(plane.z));
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    const size_t padded = centerX.size();
+    for (size_t i = 0; i < padded; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&extentX[i]);
+        const __m128 ey = _mm_loadu_ps(&extentY[i]);
+        const __m128 ez = _mm_loadu_ps(&extentZ[i]);
+
+        // 各通道累计“在某个平面外侧”的结果
+        __m128 outside = zero;
+        for (int p = 0; p < 6; ++p) {
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                _mm_add_ps(_mm_mul_ps(nz[p], cz), nw[p]));
+            const __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        const int insideMask = ~_mm_movemask_ps(outside) & 0xF;
+        if (insideMask == 0) continue;
+        for (int lane = 0; lane < 4; ++lane) {
+            if (insideMask & (1 << lane)) visible.push_back(static_cast<unsigned int>(i + lane));
+        }
+    }
+    return visible.size();
+#else
+    return CullScalar(frustum, visible);
+#endif
+}
+
+bool RunFrustumCullingBenchmark(size_t boxCount) {
+    // 随机包围盒分布在 200x20x200 的区域内，相机位于中心附近朝 -z 看
+    std::mt19937 rng(12345u);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> height(0.0f, 20.0f);
+    std::uniform_real_distribution<float> size(0.1f, 3.0f);
+    std::vector<Aabb> boxes(boxCount);
+    for (Aabb& box : boxes) {
+        const glm::vec3 center(position(rng), height(rng), position(rng));
+        const glm::vec3 extent(size(rng), size(rng), size(rng));
+        box.min = center - extent;
+        box.max = center + extent;
+    }
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(0.0f, 5.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+    const Frustum frustum = ExtractFrustum(projection * view);
+
+    FrustumCuller culler;
+    culler.SetBounds(boxes.data(), boxes.size());
+    std::vector<unsigned int> simdVisible;
+    std::vector<unsigned int> scalarVisible;
+    simdVisible.reserve(boxCount);
+    scalarVisible.reserve(boxCount);
+
+    const int kIterations = 20;
+    using Clock = std::chrono::high_resolution_clock;
+    auto start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) culler.CullScalar(frustum, scalarVisible);
+    const double scalarMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kIterations;
+
+    start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) culler.Cull(frustum, simdVisible);
+    const double simdMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kIterations;
+
+    // 与逐个 IsAabbVisible 的结果对照
+    size_t reference = 0;
+    for (const Aabb& box : boxes) reference += IsAabbVisible(frustum, box) ? 1 : 0;
+
+    const bool match = simdVisible == scalarVisible && reference == scalarVisible.size();
+    std::cout << "FRUSTUM_CULLER::BENCHMARK: boxes " << boxCount
+              << " | visible " << simdVisible.size() << " | culled " << boxCount - simdVisible.size()
+              << " | scalar " << scalarMs << " ms | simd " << simdMs << " ms"
+              << " | speedup " << (simdMs > 0.0 ? scalarMs / simdMs : 0.0) << "x"
+              << (match ? "" : " | RESULT MISMATCH") << std::endl;
+    return match;
+}
@@ -0,0 +1,55 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "EntityStore.h"
+
+// 视锥体：6 个平面（xyz 为法线，w 为距离），法线指向内侧，内部满足 dot(n, p) + w >= 0
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+// 从 投影 * 视图 矩阵提取视锥体平面（Gribb-Hartmann；透视和正交投影都适用）
+Frustum ExtractFrustum(const glm::mat4& viewProjection);
+
+// 包围盒与视锥体的相交测试（标量版本）：包围盒完全在某个平面外侧时为不可见
+bool IsAabbVisible(const Frustum& frustum, const Aabb& box);
+
+// 每帧的剔除统计（实体数）
+struct CullingStats {
+    unsigned int total = 0;
+    unsigned int cameraVisible = 0;   // 主场景：与相机视锥体相交且未被遮挡
+    unsigned int occluded = 0;        // 主场景：在视锥体内但被遮挡物挡住
+    unsigned int lightVisible = 0;    // 阴影通道：与重画的级的光源视锥体相交的投影物体（全部级命中缓存时为 0）
+    unsigned int shadowCasters = 0;
+};
+
+// 批量视锥体剔除：包围盒以 SoA（中心/半长，各分量一个数组）保存，
+// SSE 可用时每次测试 4 个包围盒，否则退化为逐个标量测试；
+// 两种路径（以及 IsAabbVisible）按相同顺序累加平面方程各项，结果一致（编译选项不得把乘加合并为 FMA）
+// 包围盒只在 SetBounds 时转换一次，之后可对多个视锥体（相机、光源）反复剔除
+class FrustumCuller {
+public:
+    void SetBounds(const Aabb* boxes, size_t count);
+    size_t Count() const { return count; }
+
+    // 把可见包围盒的下标（升序）写入 visible，返回可见数量
+    size_t Cull(const Frustum& frustum, std::vector<unsigned int>& visible) const;
+
+    // 同上，强制使用标量路径（用于对比测试）
+    size_t CullScalar(const Frustum& frustum, std::vector<unsigned int>& visible) const;
+
+private:
+    size_t count = 0;
+    // 长度补齐到 4 的倍数；补齐部分的半长为负，任何视锥体都判为不可见
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+};
+
+// 无窗口基准测试：boxCount 个随机包围盒，比较 SSE 与标量路径的耗时和结果
+// 结果不一致时返回 false（main 中通过 --bench-culling 调用）
+bool RunFrustumCullingBenchmark(size_t boxCount);
+
+#endif // FRUSTUM_CULLER_H
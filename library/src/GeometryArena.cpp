@@ -0,0 +1,260 @@
+#include "GeometryArena.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+bool RangeAllocator::Allocate(size_t size, size_t& offset) {
+    if (size == 0) {
+        offset = 0;
+        return true;
+    }
+    auto best = freeBlocks.end();
+    for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+        if (it->second >= size && (best == freeBlocks.end() || it->second < best->second)) {
+            best = it;
+            if (best->second == size) break;
+        }
+    }
+    if (best == freeBlocks.end()) return false;
+
+    offset = best->first;
+    const size_t remaining = best->second - size;
+    freeBlocks.erase(best);
+    if (remaining > 0) freeBlocks[offset + size] = remaining;
+    used += size;
+    return true;
+}
+
+void RangeAllocator::Free(size_t offset, size_t size) {
+    if (size == 0) return;
+    used -= size;
+
+    auto next = freeBlocks.lower_bound(offset);
+    // 与前一个空闲块相邻则合并
+    if (next != freeBlocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            freeBlocks.erase(prev);
+        }
+    }
+    // 与后一个空闲块相邻则合并
+    if (next != freeBlocks.end() && offset + size == next->first) {
+        size += next->second;
+        freeBlocks.erase(next);
+    }
+    freeBlocks[offset] = size;
+}
+
+void RangeAllocator::Grow(size_t newCapacity) {
+    if (newCapacity <= capacity) return;
+    const size_t oldCapacity = capacity;
+    capacity = newCapacity;
+    // 借用 Free 完成与末尾空闲块的合并（新增部分从未计入 used）
+    used += newCapacity - oldCapacity;
+    Free(oldCapacity, newCapacity - oldCapacity);
+}
+
+size_t RangeAllocator::LargestFreeBlock() const {
+    size_t largest = 0;
+    for (const auto& block : freeBlocks) largest = std::max(largest, block.second);
+    return largest;
+}
+
+GeometryArena::~GeometryArena() {
+    Release();
+}
+
+void GeometryArena::Release() {
+    for (Pool& pool : pools) {
+        if (pool.VAO) glDeleteVertexArrays(1, &pool.VAO);
+        if (pool.VBO) glDeleteBuffers(1, &pool.VBO);
+        if (pool.EBO) glDeleteBuffers(1, &pool.EBO);
+        pool = Pool();
+    }
+    allocations.clear();
+    freeHandles.clear();
+}
+
+void GeometryArena::Reserve(VertexFormat format, size_t vertexCount, size_t indexCount) {
+    Pool& pool = pools[poolIndex(format)];
+    ensureCapacity(format, std::max(vertexCount, pool.vertices.Capacity()), std::max(indexCount, pool.indices.Capacity()));
+}
+
+unsigned int GeometryArena::Add(VertexFormat format, const void* vertexData, size_t vertexCount,
+                                const unsigned int* indexData, size_t indexCount) {
+    const unsigned int handle = allocate(format, vertexCount, indexCount);
+    const GeometryAllocation& a = allocations[handle];
+    const Pool& pool = pools[poolIndex(format)];
+    const size_t stride = GetVertexStride(format);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, a.vertexOffset * stride, vertexCount * stride, vertexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, a.indexOffset * sizeof(unsigned int), indexCount * sizeof(unsigned int), indexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return handle;
+}
+
+unsigned int GeometryArena::AddFromBuffers(VertexFormat format, unsigned int srcVBO, size_t vertexCount,
+                                           unsigned int srcEBO, size_t indexCount) {
+    const unsigned int handle = allocate(format, vertexCount, indexCount);
+    const GeometryAllocation& a = allocations[handle];
+    const Pool& pool = pools[poolIndex(format)];
+    const size_t stride = GetVertexStride(format);
+
+    if (vertexCount > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, srcVBO);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool.VBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, a.vertexOffset * stride, vertexCount * stride);
+    }
+    if (indexCount > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, srcEBO);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool.EBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, a.indexOffset * sizeof(unsigned int),
+                            indexCount * sizeof(unsigned int));
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return handle;
+}
+
+void GeometryArena::Remove(unsigned int handle) {
+    if (handle >= allocations.size() || !allocations[handle].live) return;
+    GeometryAllocation& a = allocations[handle];
+    Pool& pool = pools[poolIndex(a.format)];
+    pool.vertices.Free(a.vertexOffset, a.vertexCount);
+    pool.indices.Free(a.indexOffset, a.indexCount);
+    a = GeometryAllocation();
+    freeHandles.push_back(handle);
+}
+
+unsigned int GeometryArena::allocate(VertexFormat format, size_t vertexCount, size_t indexCount) {
+    Pool& pool = pools[poolIndex(format)];
+    size_t vertexOffset = 0;
+    size_t indexOffset = 0;
+    // 空间不足（或碎片化导致没有足够大的连续块）时扩容，新增空间接在末尾，重试必然成功
+    if (!pool.vertices.Allocate(vertexCount, vertexOffset)) {
+        ensureCapacity(format, std::max(pool.vertices.Capacity() * 2, pool.vertices.Capacity() + vertexCount),
+                       pool.indices.Capacity());
+        pool.vertices.Allocate(vertexCount, vertexOffset);
+    }
+    if (!pool.indices.Allocate(indexCount, indexOffset)) {
+        ensureCapacity(format, pool.vertices.Capacity(),
+                       std::max(pool.indices.Capacity() * 2, pool.indices.Capacity() + indexCount));
+        pool.indices.Allocate(indexCount, indexOffset);
+    }
+    if (pool.VAO == 0) ensureCapacity(format, pool.vertices.Capacity(), pool.indices.Capacity());
+
+    unsigned int handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = static_cast<unsigned int>(allocations.size());
+        allocations.emplace_back();
+    }
+    GeometryAllocation& a = allocations[handle];
+    a.format = format;
+    a.vertexOffset = static_cast<unsigned int>(vertexOffset);
+    a.vertexCount = static_cast<unsigned int>(vertexCount);
+    a.indexOffset = static_cast<unsigned int>(indexOffset);
+    a.indexCount = static_cast<unsigned int>(indexCount);
+    a.live = true;
+    return handle;
+}
+
+// 把缓冲扩大到 newBytes，旧内容在 GPU 上复制过去（buffer 为 0 时直接创建）
+void GeometryArena::growBuffer(unsigned int& buffer, size_t oldBytes, size_t newBytes) {
+    unsigned int grown = 0;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+    if (buffer != 0) {
+        if (oldBytes > 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &buffer);
+        ++growCount;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    buffer = grown;
+}
+
+void GeometryArena::ensureCapacity(VertexFormat format, size_t vertexCount, size_t indexCount) {
+    Pool& pool = pools[poolIndex(format)];
+    const size_t stride = GetVertexStride(format);
+    bool changed = pool.VAO == 0;
+
+    if (pool.VBO == 0 || vertexCount > pool.vertices.Capacity()) {
+        vertexCount = std::max<size_t>(vertexCount, 1);
+        growBuffer(pool.VBO, pool.vertices.Capacity() * stride, vertexCount * stride);
+        pool.vertices.Grow(vertexCount);
+        changed = true;
+    }
+    if (pool.EBO == 0 || indexCount > pool.indices.Capacity()) {
+        indexCount = std::max<size_t>(indexCount, 1);
+        growBuffer(pool.EBO, pool.indices.Capacity() * sizeof(unsigned int),
+                   indexCount * sizeof(unsigned int));
+        pool.indices.Grow(indexCount);
+        changed = true;
+    }
+    if (!changed) return;
+
+    // 缓冲换了新对象，VAO 需要重新指向（VAO 本身不变，已持有它的网格无需更新）
+    if (pool.VAO == 0) glGenVertexArrays(1, &pool.VAO);
+    glBindVertexArray(pool.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, pool.VBO);
+    SetupVertexAttributes(format);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.EBO);
+    glBindVertexArray(0);
+    Mesh::ResetVertexArrayBinding();
+}
+
+GeometryArenaStats GeometryArena::GetStats() const {
+    GeometryArenaStats stats;
+    stats.allocations = allocations.size() - freeHandles.size();
+    stats.growCount = growCount;
+
+    size_t freeBytes = 0;
+    size_t scatteredBytes = 0;  // 不在各区间最大空闲块内的空闲字节
+    for (size_t i = 0; i < 2; ++i) {
+        const Pool& pool = pools[i];
+        const size_t stride = GetVertexStride(i == 1 ? VertexFormat::Packed : VertexFormat::Float);
+        stats.vertexBytesUsed += pool.vertices.Used() * stride;
+        stats.vertexBytesCapacity += pool.vertices.Capacity() * stride;
+        stats.indexBytesUsed += pool.indices.Used() * sizeof(unsigned int);
+        stats.indexBytesCapacity += pool.indices.Capacity() * sizeof(unsigned int);
+        stats.freeBlocks += pool.vertices.FreeBlockCount() + pool.indices.FreeBlockCount();
+
+        const size_t vertexFree = (pool.vertices.Capacity() - pool.vertices.Used()) * stride;
+        const size_t indexFree = (pool.indices.Capacity() - pool.indices.Used()) * sizeof(unsigned int);
+        freeBytes += vertexFree + indexFree;
+        scatteredBytes += vertexFree - pool.vertices.LargestFreeBlock() * stride;
+        scatteredBytes += indexFree - pool.indices.LargestFreeBlock() * sizeof(unsigned int);
+    }
+
+    const size_t capacityBytes = stats.vertexBytesCapacity + stats.indexBytesCapacity;
+    if (capacityBytes > 0) {
+        stats.utilization = static_cast<float>(stats.vertexBytesUsed + stats.indexBytesUsed) / static_cast<float>(capacityBytes);
+    }
+    if (freeBytes > 0) {
+        stats.fragmentation = static_cast<float>(scatteredBytes) / static_cast<float>(freeBytes);
+    }
+    return stats;
+}
+
+void GeometryArena::LogStats(const char* label) const {
+    const GeometryArenaStats stats = GetStats();
+    std::cout << "GEOMETRY_ARENA::" << label << ": allocations " << stats.allocations
+              << " | vertex " << stats.vertexBytesUsed / 1024 << "/" << stats.vertexBytesCapacity / 1024 << " KB"
+              << " | index " << stats.indexBytesUsed / 1024 << "/" << stats.indexBytesCapacity / 1024 << " KB"
+              << " | utilization " << stats.utilization * 100.0f << "%"
+              << " | free blocks " << stats.freeBlocks
+              << " | fragmentation " << stats.fragmentation * 100.0f << "%"
+              << " | grows " << stats.growCount << std::endl;
+}
@@ -0,0 +1,109 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "Mesh.h"
+
+// 区间分配器：在 [0, capacity) 中按单位（顶点或索引）分配连续区间
+// 空闲块按起始位置有序保存，分配时选最小的够用块（best-fit），释放时与相邻空闲块合并
+class RangeAllocator {
+public:
+    // 成功时写入 offset 并返回 true；空间不足返回 false（由调用方扩容后重试）
+    bool Allocate(size_t size, size_t& offset);
+    void Free(size_t offset, size_t size);
+
+    // 容量扩大到 newCapacity，新增部分并入末尾空闲块
+    void Grow(size_t newCapacity);
+
+    size_t Capacity() const { return capacity; }
+    size_t Used() const { return used; }
+    size_t FreeBlockCount() const { return freeBlocks.size(); }
+    size_t LargestFreeBlock() const;
+
+private:
+    std::map<size_t, size_t> freeBlocks;  // 起始位置 -> 长度
+    size_t capacity = 0;
+    size_t used = 0;
+};
+
+// 一个网格在共享缓冲中的位置
+struct GeometryAllocation {
+    VertexFormat format = VertexFormat::Float;
+    unsigned int vertexOffset = 0;  // 单位：顶点（绘制时加到 baseVertex 上）
+    unsigned int vertexCount = 0;
+    unsigned int indexOffset = 0;   // 单位：索引
+    unsigned int indexCount = 0;
+    bool live = false;
+};
+
+// 共享缓冲的使用情况（两种顶点格式合计）
+struct GeometryArenaStats {
+    size_t allocations = 0;
+    size_t vertexBytesUsed = 0;
+    size_t vertexBytesCapacity = 0;
+    size_t indexBytesUsed = 0;
+    size_t indexBytesCapacity = 0;
+    size_t freeBlocks = 0;
+    float utilization = 0.0f;    // 已用字节 / 总容量
+    float fragmentation = 0.0f;  // 不在最大空闲块内的空闲字节 / 空闲总量（0 表示每个缓冲的空闲空间都连续）
+    unsigned int growCount = 0;  // 扩容次数
+};
+
+// 几何数据共享池：所有静态网格的顶点/索引分配在少数几个大缓冲里
+// 每种顶点格式一组 VAO/VBO/EBO（属性布局不同），同格式的网格共用一个 VAO，
+// 绘制时用 indexOffset / baseVertex 选出各自的范围，不再逐网格切换 VAO
+// GL 对象在第一次分配时创建；容量不足时按 2 倍扩容，用 glCopyBufferSubData 在 GPU 上搬移旧数据
+class GeometryArena {
+public:
+    GeometryArena() = default;
+    ~GeometryArena();
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // 预留容量（单位：顶点/索引），避免加载过程中多次扩容
+    void Reserve(VertexFormat format, size_t vertexCount, size_t indexCount);
+
+    // 以下两个函数返回分配句柄（空间不足时自动扩容，总能成功）
+    // 从内存上传
+    unsigned int Add(VertexFormat format, const void* vertexData, size_t vertexCount,
+                     const unsigned int* indexData, size_t indexCount);
+
+    // 从已有的 GL 缓冲复制（GPU 到 GPU，不需要 CPU 端数据）
+    unsigned int AddFromBuffers(VertexFormat format, unsigned int srcVBO, size_t vertexCount,
+                                unsigned int srcEBO, size_t indexCount);
+
+    void Remove(unsigned int handle);
+
+    const GeometryAllocation& Get(unsigned int handle) const { return allocations[handle]; }
+
+    // 某种格式的共享 VAO（尚未分配过该格式时为 0）
+    unsigned int GetVertexArray(VertexFormat format) const { return pools[poolIndex(format)].VAO; }
+
+    GeometryArenaStats GetStats() const;
+    void LogStats(const char* label) const;
+
+    // 删除所有 GL 对象（必须在 GL 上下文销毁前调用，此后不应再有网格引用本对象）
+    void Release();
+
+private:
+    struct Pool {
+        unsigned int VAO = 0, VBO = 0, EBO = 0;
+        RangeAllocator vertices;
+        RangeAllocator indices;
+    };
+
+    static size_t poolIndex(VertexFormat format) { return format == VertexFormat::Packed ? 1 : 0; }
+
+    unsigned int allocate(VertexFormat format, size_t vertexCount, size_t indexCount);
+    void growBuffer(unsigned int& buffer, size_t oldBytes, size_t newBytes);
+    void ensureCapacity(VertexFormat format, size_t vertexCount, size_t indexCount);
+
+    Pool pools[2];
+    std::vector<GeometryAllocation> allocations;
+    std::vector<unsigned int> freeHandles;
+    unsigned int growCount = 0;
+};
+
+#endif // GEOMETRY_ARENA_H
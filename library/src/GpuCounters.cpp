@@ -0,0 +1,55 @@
+#include "GpuCounters.h"
+
+#include <cstring>
+
+bool HasPipelineStatisticsQuery() {
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && std::strcmp(name, "GL_ARB_pipeline_statistics_query") == 0) return true;
+    }
+    return false;
+}
+
+GpuQueryCounter::~GpuQueryCounter() {
+    Cleanup();
+}
+
+void GpuQueryCounter::Initialize(GLenum queryTarget) {
+    Cleanup();
+    target = queryTarget;
+    glGenQueries(2, queries);
+}
+
+void GpuQueryCounter::Cleanup() {
+    if (queries[0] != 0) {
+        glDeleteQueries(2, queries);
+        queries[0] = queries[1] = 0;
+    }
+    issued[0] = issued[1] = false;
+    current = 0;
+    result = 0;
+}
+
+void GpuQueryCounter::Begin() {
+    if (queries[0] == 0) return;
+    // 先收取这个查询对象上一次的结果（两帧之前发出，通常已完成）
+    if (issued[current]) {
+        GLint available = 0;
+        glGetQueryObjectiv(queries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 value = 0;
+            glGetQueryObjectui64v(queries[current], GL_QUERY_RESULT, &value);
+            result = value;
+        }
+    }
+    glBeginQuery(target, queries[current]);
+}
+
+void GpuQueryCounter::End() {
+    if (queries[0] == 0) return;
+    glEndQuery(target);
+    issued[current] = true;
+    current ^= 1;
+}
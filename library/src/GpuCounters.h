@@ -0,0 +1,41 @@
+#ifndef GPU_COUNTERS_H
+#define GPU_COUNTERS_H
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// GL_ARB_pipeline_statistics_query 的片元着色器调用次数查询（glad 只生成了核心 3.3，常量在此定义）
+const GLenum kFragmentShaderInvocationsQuery = 0x82F4;
+
+// 驱动是否支持 GL_ARB_pipeline_statistics_query（需要有效的 GL 上下文）
+bool HasPipelineStatisticsQuery();
+
+// 单个计数查询（GL_SAMPLES_PASSED、GL_TIME_ELAPSED、片元着色器调用次数等）
+// 两个查询对象轮流使用：本帧读取上一帧的结果（结果未就绪时保留旧值），不会让 CPU 等待 GPU
+class GpuQueryCounter {
+public:
+    GpuQueryCounter() = default;
+    ~GpuQueryCounter();
+    GpuQueryCounter(const GpuQueryCounter&) = delete;
+    GpuQueryCounter& operator=(const GpuQueryCounter&) = delete;
+
+    void Initialize(GLenum target);
+    void Cleanup();
+    bool IsInitialized() const { return queries[0] != 0; }
+
+    // 包住要统计的绘制（同一 target 的查询不能嵌套）
+    void Begin();
+    void End();
+
+    // 最近一次可用的结果
+    uint64_t GetResult() const { return result; }
+
+private:
+    GLenum target = GL_SAMPLES_PASSED;
+    GLuint queries[2] = { 0, 0 };
+    bool issued[2] = { false, false };
+    int current = 0;
+    uint64_t result = 0;
+};
+
+#endif // GPU_COUNTERS_H
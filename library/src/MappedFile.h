@@ -0,0 +1,41 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// 只读内存映射文件（Windows 使用 CreateFileMapping，其他平台使用 mmap）
+// 用于大文件的零拷贝读取：映射后直接在页缓存上解析，不再复制到 std::string
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 打开并映射整个文件，失败返回 false
+    // 空文件也视为成功（Data() 为 nullptr，Size() 为 0）
+    bool Open(const std::string& path);
+
+    // 解除映射并关闭文件
+    void Close();
+
+    const char* Data() const { return data; }
+    size_t Size() const { return size; }
+    bool IsOpen() const { return opened; }
+
+private:
+    const char* data;
+    size_t size;
+    bool opened;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+};
+
+#endif // MAPPED_FILE_H
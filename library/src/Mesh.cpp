@@ -1,20 +1,218 @@
 #include "Mesh.h"  // ͷļ
+#include "GeometryArena.h"
+
+#include <cstddef>
+
+MeshMemoryStats Mesh::memoryStats;
+unsigned int Mesh::boundVertexArray = 0;
+
+namespace {
+
+// ÿλƶҪõķ
+const UniformHandle kPosScaleUniform("posScale");
+const UniformHandle kPosBiasUniform("posBias");
+const UniformHandle kOctNormalsUniform("octNormals");
+
+} // namespace
 
 // 캯ʵ
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices)
-    : vertices(vertices), indices(indices) {
-    setupMesh();
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<SubMesh> subMeshes)
+    : vertices(std::move(vertices)), indices(std::move(indices)), subMeshes(std::move(subMeshes)),
+      vertexCount(static_cast<unsigned int>(this->vertices.size())),
+      indexCount(static_cast<unsigned int>(this->indices.size())) {
+    if (this->subMeshes.empty()) {
+        SubMesh whole;
+        whole.indexCount = indexCount;
+        this->subMeshes.push_back(whole);
+    }
+    setupMesh(this->vertices.data(), this->indices.data());
+
+    cpuBytes = this->vertices.capacity() * sizeof(Vertex) + this->indices.capacity() * sizeof(unsigned int);
+    memoryStats.cpuBytes += cpuBytes;
 }
 
-// ƺʵ
-void Mesh::Draw(Shader& shader) {
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+Mesh::Mesh(const void* vertexData, size_t vertexCount, VertexFormat format, const glm::vec3& posScale, const glm::vec3& posBias,
+           const unsigned int* indexData, size_t indexCount, std::vector<SubMesh> subMeshes)
+    : subMeshes(std::move(subMeshes)),
+      vertexCount(static_cast<unsigned int>(vertexCount)),
+      indexCount(static_cast<unsigned int>(indexCount)),
+      format(format), posScale(posScale), posBias(posBias) {
+    setupMesh(vertexData, indexData);
+
+    // δ CPU 
+    memoryStats.cpuBytesSaved += vertexCount * sizeof(Vertex) + indexCount * sizeof(unsigned int);
+}
+
+Mesh::~Mesh() {
+    destroy();
+}
+
+Mesh::Mesh(Mesh&& other) noexcept
+    : vertices(std::move(other.vertices)), indices(std::move(other.indices)), subMeshes(std::move(other.subMeshes)),
+      VAO(other.VAO), VBO(other.VBO), EBO(other.EBO),
+      vertexCount(other.vertexCount), indexCount(other.indexCount),
+      format(other.format), posScale(other.posScale), posBias(other.posBias),
+      cpuBytes(other.cpuBytes), arena(other.arena), arenaHandle(other.arenaHandle) {
+    other.VAO = other.VBO = other.EBO = 0;
+    other.vertexCount = other.indexCount = 0;
+    other.cpuBytes = 0;
+    other.arena = nullptr;
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        vertices = std::move(other.vertices);
+        indices = std::move(other.indices);
+        subMeshes = std::move(other.subMeshes);
+        VAO = other.VAO;
+        VBO = other.VBO;
+        EBO = other.EBO;
+        vertexCount = other.vertexCount;
+        indexCount = other.indexCount;
+        format = other.format;
+        posScale = other.posScale;
+        posBias = other.posBias;
+        cpuBytes = other.cpuBytes;
+        arena = other.arena;
+        arenaHandle = other.arenaHandle;
+        other.VAO = other.VBO = other.EBO = 0;
+        other.vertexCount = other.indexCount = 0;
+        other.cpuBytes = 0;
+        other.arena = nullptr;
+    }
+    return *this;
+}
+
+// ͷ GL 󣨻е䣩ڴͳп۳ߵĶκ£
+void Mesh::destroy() {
+    if (VAO == 0 && arena == nullptr) return;
+    memoryStats.gpuBytes -= GetGpuBytes();
+    memoryStats.cpuBytes -= cpuBytes;
+    memoryStats.meshCount--;
+    if (arena) {
+        arena->Remove(arenaHandle);
+        arena = nullptr;
+    } else {
+        if (boundVertexArray == VAO) boundVertexArray = 0;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+    cpuBytes = 0;
+}
+
+void Mesh::MoveToArena(GeometryArena& target) {
+    if (arena || VAO == 0) return;
+    arenaHandle = target.AddFromBuffers(format, VBO, vertexCount, EBO, indexCount);
+    arena = &target;
+
+    if (boundVertexArray == VAO) boundVertexArray = 0;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+}
+
+void Mesh::ResetVertexArrayBinding() {
     glBindVertexArray(0);
+    boundVertexArray = 0;
+}
+
+void Mesh::ReleaseCpuGeometry() {
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
+    memoryStats.cpuBytes -= cpuBytes;
+    memoryStats.cpuBytesSaved += cpuBytes;
+    cpuBytes = 0;
+}
+
+size_t Mesh::GetGpuBytes() const {
+    return vertexCount * GetVertexStride(format) + indexCount * sizeof(unsigned int);
+}
+
+// ƺʵ
+void Mesh::Draw(Shader& shader, const glm::mat4& model) {
+    SetVertexUniforms(shader);
+    bindVertexArray();
+
+    const InstanceData instance = MakeInstanceData(model);
+    for (unsigned int i = 0; i < 7; ++i) glDisableVertexAttribArray(kInstanceAttribLocation + i);
+    for (int column = 0; column < 4; ++column) {
+        glVertexAttrib4fv(kInstanceAttribLocation + column, &instance.model[column][0]);
+    }
+    for (int column = 0; column < 3; ++column) {
+        glVertexAttrib3fv(kInstanceAttribLocation + 4 + column, &instance.normalMatrix[column][0]);
+    }
+    drawRanges(1);
+}
+
+void Mesh::DrawInstanced(unsigned int instanceBuffer, size_t firstInstance, unsigned int instanceCount) const {
+    bindVertexArray();
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    SetupInstanceAttributes(firstInstance * sizeof(InstanceData));
+    drawRanges(instanceCount);
+}
+
+void Mesh::SetVertexUniforms(Shader& shader) const {
+    shader.setVec3(kPosScaleUniform, posScale);
+    shader.setVec3(kPosBiasUniform, posBias);
+    shader.setBool(kOctNormalsUniform, format == VertexFormat::Packed);
+}
+
+void Mesh::bindVertexArray() const {
+    const unsigned int vao = arena ? arena->GetVertexArray(format) : VAO;
+    if (vao != boundVertexArray) {
+        glBindVertexArray(vao);
+        boundVertexArray = vao;
+    }
+}
+
+void Mesh::drawRanges(unsigned int instanceCount) const {
+    // λڹʱΧټϱڳеƫ
+    unsigned int indexBase = 0;
+    int vertexBase = 0;
+    if (arena) {
+        const GeometryAllocation& allocation = arena->Get(arenaHandle);
+        indexBase = allocation.indexOffset;
+        vertexBase = static_cast<int>(allocation.vertexOffset);
+    }
+    for (const SubMesh& sub : subMeshes) {
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, sub.indexCount, GL_UNSIGNED_INT,
+                                          (void*)((indexBase + sub.indexOffset) * sizeof(unsigned int)),
+                                          instanceCount, vertexBase + sub.baseVertex);
+    }
+}
+
+InstanceData MakeInstanceData(const glm::mat4& model) {
+    InstanceData instance;
+    instance.model = model;
+    instance.normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+    instance.padding[0] = instance.padding[1] = instance.padding[2] = 0.0f;
+    return instance;
+}
+
+void SetupInstanceAttributes(size_t byteOffset) {
+    const GLsizei stride = sizeof(InstanceData);
+    for (unsigned int column = 0; column < 4; ++column) {
+        const unsigned int location = kInstanceAttribLocation + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)(byteOffset + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
+    for (unsigned int column = 0; column < 3; ++column) {
+        const unsigned int location = kInstanceAttribLocation + 4 + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride,
+                              (void*)(byteOffset + offsetof(InstanceData, normalMatrix) + column * sizeof(glm::vec3)));
+        glVertexAttribDivisor(location, 1);
+    }
 }
 
 // ʼʵ
-void Mesh::setupMesh() {
+void Mesh::setupMesh(const void* vertexData, const unsigned int* indexData) {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -22,10 +220,32 @@ void Mesh::setupMesh() {
     glBindVertexArray(VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * GetVertexStride(format), vertexData, GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indexData, GL_STATIC_DRAW);
+
+    memoryStats.meshCount++;
+    memoryStats.gpuBytes += GetGpuBytes();
+
+    SetupVertexAttributes(format);
+
+    glBindVertexArray(0);
+    boundVertexArray = 0;
+}
+
+void SetupVertexAttributes(VertexFormat format) {
+    if (format == VertexFormat::Packed) {
+        // ԲһԭֵתΪ floatɫ
+        const GLsizei stride = sizeof(PackedVertex);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_FALSE, stride, (void*)offsetof(PackedVertex, Pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_FALSE, stride, (void*)offsetof(PackedVertex, Normal));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, TexCoords));
+        return;
+    }
 
     // λ
     glEnableVertexAttribArray(0);
@@ -38,6 +258,4 @@ void Mesh::setupMesh() {
     // 
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-
-    glBindVertexArray(0);
 }
\ No newline at end of file
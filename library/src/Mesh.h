@@ -3,6 +3,8 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include "Shader.h"  //  Shader.hDraw  Shader
 
@@ -18,21 +20,135 @@ struct Vertex {
     }
 };
 
+// ѹ㣨16 ֽڣλ԰ΧΪ 16 λΪ룬Ϊ뾫
+// / VertexPacking.hɫ posScale/posBias/octNormals ԭ
+struct PackedVertex {
+    uint16_t Pos[3];
+    uint16_t Padding;       // 뵽 4 ֽ
+    int16_t Normal[2];      // 32767
+    uint16_t TexCoords[2];  // 뾫ȸ
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+// 㻺Ĳ
+enum class VertexFormat : uint32_t {
+    Float = 0,   // Vertex32 ֽڣ
+    Packed = 1   // PackedVertex16 ֽڣ
+};
+
+inline size_t GetVertexStride(VertexFormat format) {
+    return format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+//  format õǰ VAO Ķ 0~2Եǰ󶨵 GL_ARRAY_BUFFER
+void SetupVertexAttributes(VertexFormat format);
+
+// ÿʵݣģ;location 3~6ͷ߾location 7~9
+// ߾Ϊģ; 3x3 תã CPU ÿʵһΣɫв𶥵
+struct InstanceData {
+    glm::mat4 model;
+    glm::mat3 normalMatrix;
+    float padding[3];
+};
+static_assert(sizeof(InstanceData) == 112, "InstanceData must stay 112 bytes");
+
+const unsigned int kInstanceAttribLocation = 3;
+
+InstanceData MakeInstanceData(const glm::mat4& model);
+
+// ѵǰ VAO ʵ 3~9 ָǰ GL_ARRAY_BUFFER  byteOffset Ϊ 1
+// GL 3.3 û baseInstanceƲͬΧʵʱͨı byteOffset ʵ
+void SetupInstanceAttributes(size_t byteOffset);
+
+class GeometryArena;
+
+// 񣺹ͬһ VBO/EBO һΧ
+struct SubMesh {
+    unsigned int indexOffset = 0;  //  EBO еʼ
+    unsigned int indexCount = 0;   // 
+    int baseVertex = 0;            // ʱӵϵĶƫ
+    std::string name;              // OBJ g/o
+    std::string material;          // OBJ usemtl
+};
+
+//  Mesh ʵļڴϼƣֽڣ
+struct MeshMemoryStats {
+    size_t meshCount = 0;
+    size_t gpuBytes = 0;       // VBO + EBO
+    size_t cpuBytes = 0;       // פ CPU  vertices/indices
+    size_t cpuBytesSaved = 0;  // 롰ÿ񶼱һݸ CPU Ƚʡֽ
+};
+
 // Mesh 
+// ֻƶܸƣMesh ռԼ VAO/VBO/EBOʱͷţ GL ǰ
 class Mesh {
 public:
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
-    unsigned int VAO, VBO, EBO;
+    std::vector<SubMesh> subMeshes;
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    unsigned int vertexCount;
+    unsigned int indexCount;
+
+    // 㲼ֺλ÷㲼ʱΪȱ任
+    VertexFormat format = VertexFormat::Float;
+    glm::vec3 posScale = glm::vec3(1.0f);
+    glm::vec3 posBias = glm::vec3(0.0f);
+
+    // 캯ֵƶԱ÷ std::move 뼴ɱ⸴ƣ
+    // subMeshes ΪʱΪһ
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<SubMesh> subMeshes = {});
+
+    // ֱӴڴ棨ӳ .meshbin 棩ϴ GPU CPU ˸
+    // vertexData Ĳ format Vertex  PackedVertex
+    Mesh(const void* vertexData, size_t vertexCount, VertexFormat format, const glm::vec3& posScale, const glm::vec3& posBias,
+         const unsigned int* indexData, size_t indexCount, std::vector<SubMesh> subMeshes);
+
+    ~Mesh();
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+
+    // Ƶʵ÷ uniform VAOΧλƣ
+    // ʵ鱻رգģ;ͷ߾ԳԴ
+    // һλʹͬһ VAO ʱظ󶨣ƽҲһɺ ResetVertexArrayBinding
+    void Draw(Shader& shader, const glm::mat4& model);
 
-    // 캯
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices);
+    // ʵƣinstanceBuffer д firstInstance ʼ instanceCount  InstanceData
+    //  uniform  SetVertexUniforms ãȾ仯ʱã
+    void SetVertexUniforms(Shader& shader) const;
+    void DrawInstanced(unsigned int instanceBuffer, size_t firstInstance, unsigned int instanceCount) const;
 
-    // ƺ
-    void Draw(Shader& shader);
+    // ѼݸƵأGPU ڸƣɾԼ VAO/VBO/EBO˺󰴳еƫƻ
+    // arena ȱø
+    void MoveToArena(GeometryArena& arena);
+    bool InArena() const { return arena != nullptr; }
+
+    //  VAO  Draw ¼İ״̬޸ VAO ʱҲҪã
+    static void ResetVertexArrayBinding();
+
+    // GPU-only ģʽϴɺͷ CPU ˵ vertices/indices
+    void ReleaseCpuGeometry();
+
+    size_t GetGpuBytes() const;
+    size_t GetCpuBytes() const { return cpuBytes; }
+
+    static const MeshMemoryStats& GetMemoryStats() { return memoryStats; }
 
 private:
-    void setupMesh();
+    void setupMesh(const void* vertexData, const unsigned int* indexData);
+    void destroy();
+    void bindVertexArray() const;
+    void drawRanges(unsigned int instanceCount) const;
+
+    size_t cpuBytes = 0;  // Ѽ memoryStats  CPU ֽ
+
+    GeometryArena* arena = nullptr;  // ǿʱλڹأVAO/VBO/EBO Ϊ 0
+    unsigned int arenaHandle = 0;
+
+    static MeshMemoryStats memoryStats;
+    static unsigned int boundVertexArray;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "MeshCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// 缓存格式版本：Vertex 布局或文件内容的生成方式改变时递增，旧缓存自动失效
+// 版本 5 起写入前校验索引范围，读取时只检查子网格记录，不再逐个检查索引
+const uint32_t kMeshCacheVersion = 5;
+const char kMeshCacheMagic[8] = { 'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0' };
+
+struct MeshCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexStride;   // 顶点结构体大小，防止结构体布局变化后误读
+    uint64_t sourceSize;
+    int64_t sourceMTime;
+    uint64_t sourceHash;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t subMeshCount;
+    uint32_t stringBytes;    // 子网格名称区的长度（已按 4 字节补齐）
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t buildFlags;
+    uint32_t vertexFormat;   // VertexFormat
+};
+static_assert(sizeof(MeshCacheHeader) == 88, "MeshCacheHeader layout must stay fixed");
+
+// 名称以 (偏移, 长度) 引用名称区中的字节，不含结尾 '\0'
+struct MeshCacheSubMesh {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    int32_t baseVertex;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t materialOffset;
+    uint32_t materialLength;
+    uint32_t reserved;
+};
+static_assert(sizeof(MeshCacheSubMesh) == 32, "MeshCacheSubMesh layout must stay fixed");
+
+inline uint64_t Rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+} // namespace
+
+uint64_t HashBytes(const void* data, size_t size) {
+    const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = 0x27D4EB2F165667C5ULL ^ (static_cast<uint64_t>(size) * kPrime1);
+
+    const size_t wordCount = size / 8;
+    for (size_t i = 0; i < wordCount; ++i) {
+        uint64_t w;
+        std::memcpy(&w, p + i * 8, 8);
+        h ^= Rotl64(w * kPrime2, 31) * kPrime1;
+        h = Rotl64(h, 27) * kPrime1 + 0x85EBCA77C2B2AE63ULL;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p + wordCount * 8, size % 8);
+    h ^= Rotl64(tail * kPrime2, 31) * kPrime1;
+
+    h ^= h >> 33; h *= kPrime2;
+    h ^= h >> 29; h *= kPrime1;
+    h ^= h >> 32;
+    return h;
+}
+
+MeshCacheSource MakeMeshCacheSource(const std::string& path, const char* data, size_t size) {
+    MeshCacheSource source;
+    source.size = size;
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    source.mtime = ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+    source.hash = HashBytes(data, size);
+    return source;
+}
+
+std::string GetMeshCachePath(const std::string& sourcePath) {
+    return sourcePath + ".meshbin";
+}
+
+bool WriteMeshCache(const std::string& cachePath, const MeshCacheSource& source,
+                    const void* vertexData, size_t vertexCount, VertexFormat format,
+                    const std::vector<unsigned int>& indices,
+                    const std::vector<SubMesh>& subMeshes,
+                    const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    // 索引在读取时直接交给 glBufferData，只有范围正确的数据才写入缓存：
+    // 每个子网格的索引加上 baseVertex 后都须小于顶点数
+    for (const SubMesh& sub : subMeshes) {
+        bool valid = sub.baseVertex >= 0 && static_cast<size_t>(sub.baseVertex) <= vertexCount &&
+                     static_cast<size_t>(sub.indexOffset) + sub.indexCount <= indices.size();
+        const size_t limit = valid ? vertexCount - static_cast<size_t>(sub.baseVertex) : 0;
+        for (unsigned int i = 0; valid && i < sub.indexCount; ++i) {
+            valid = indices[sub.indexOffset + i] < limit;
+        }
+        if (!valid) {
+            std::cerr << "WARNING::MESH_CACHE::INDEX_OUT_OF_RANGE: " << cachePath << " (not written)" << std::endl;
+            return false;
+        }
+    }
+
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, kMeshCacheMagic, sizeof(header.magic));
+    header.version = kMeshCacheVersion;
+    header.vertexStride = static_cast<uint32_t>(GetVertexStride(format));
+    header.vertexFormat = static_cast<uint32_t>(format);
+    header.sourceSize = source.size;
+    header.sourceMTime = source.mtime;
+    header.sourceHash = source.hash;
+    header.buildFlags = source.buildFlags;
+    header.vertexCount = static_cast<uint32_t>(vertexCount);
+    header.indexCount = static_cast<uint32_t>(indices.size());
+    header.subMeshCount = static_cast<uint32_t>(subMeshes.size());
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = boundsMin[i];
+        header.boundsMax[i] = boundsMax[i];
+    }
+
+    std::vector<MeshCacheSubMesh> records(subMeshes.size());
+    std::string strings;
+    for (size_t i = 0; i < subMeshes.size(); ++i) {
+        records[i].indexOffset = subMeshes[i].indexOffset;
+        records[i].indexCount = subMeshes[i].indexCount;
+        records[i].baseVertex = subMeshes[i].baseVertex;
+        records[i].nameOffset = static_cast<uint32_t>(strings.size());
+        records[i].nameLength = static_cast<uint32_t>(subMeshes[i].name.size());
+        strings += subMeshes[i].name;
+        records[i].materialOffset = static_cast<uint32_t>(strings.size());
+        records[i].materialLength = static_cast<uint32_t>(subMeshes[i].material.size());
+        strings += subMeshes[i].material;
+        records[i].reserved = 0;
+    }
+    strings.resize((strings.size() + 3) & ~size_t(3), '\0');
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "WARNING::MESH_CACHE::WRITE_FAILED: " << cachePath << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(MeshCacheSubMesh));
+        out.write(strings.data(), strings.size());
+        out.write(static_cast<const char*>(vertexData), vertexCount * GetVertexStride(format));
+        out.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(unsigned int));
+        if (!out.good()) {
+            out.close();
+            std::remove(tempPath.c_str());
+            std::cerr << "WARNING::MESH_CACHE::WRITE_FAILED: " << cachePath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::remove(tempPath.c_str());
+        std::cerr << "WARNING::MESH_CACHE::WRITE_FAILED: " << cachePath << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MeshCacheReader::Open(const std::string& cachePath, const MeshCacheSource& source) {
+    if (!file.Open(cachePath) || file.Size() < sizeof(MeshCacheHeader)) {
+        return false;
+    }
+
+    MeshCacheHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kMeshCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != kMeshCacheVersion ||
+        header.vertexFormat > static_cast<uint32_t>(VertexFormat::Packed) ||
+        header.vertexStride != GetVertexStride(static_cast<VertexFormat>(header.vertexFormat))) {
+        return false;
+    }
+
+    // 源文件已改变：缓存过期
+    if (header.sourceSize != source.size ||
+        header.sourceMTime != source.mtime ||
+        header.sourceHash != source.hash ||
+        header.buildFlags != source.buildFlags) {
+        return false;
+    }
+
+    const size_t subMeshBytes = static_cast<size_t>(header.subMeshCount) * sizeof(MeshCacheSubMesh);
+    const size_t vertexBytes = static_cast<size_t>(header.vertexCount) * header.vertexStride;
+    const size_t indexBytes = static_cast<size_t>(header.indexCount) * sizeof(unsigned int);
+    const size_t stringBytes = header.stringBytes;
+    if (file.Size() != sizeof(MeshCacheHeader) + subMeshBytes + stringBytes + vertexBytes + indexBytes) {
+        std::cerr << "WARNING::MESH_CACHE::TRUNCATED: " << cachePath << std::endl;
+        return false;
+    }
+
+    const char* p = file.Data() + sizeof(MeshCacheHeader);
+    const char* strings = p + subMeshBytes;
+    subMeshes.resize(header.subMeshCount);
+    for (uint32_t i = 0; i < header.subMeshCount; ++i) {
+        MeshCacheSubMesh record;
+        std::memcpy(&record, p + i * sizeof(MeshCacheSubMesh), sizeof(record));
+        if (static_cast<size_t>(record.nameOffset) + record.nameLength > stringBytes ||
+            static_cast<size_t>(record.materialOffset) + record.materialLength > stringBytes ||
+            static_cast<size_t>(record.indexOffset) + record.indexCount > header.indexCount ||
+            record.baseVertex < 0 || static_cast<uint32_t>(record.baseVertex) > header.vertexCount) {
+            std::cerr << "WARNING::MESH_CACHE::CORRUPT: " << cachePath << std::endl;
+            return false;
+        }
+        subMeshes[i].indexOffset = record.indexOffset;
+        subMeshes[i].indexCount = record.indexCount;
+        subMeshes[i].baseVertex = record.baseVertex;
+        subMeshes[i].name.assign(strings + record.nameOffset, record.nameLength);
+        subMeshes[i].material.assign(strings + record.materialOffset, record.materialLength);
+    }
+    p += subMeshBytes + stringBytes;
+
+    vertices = p;
+    format = static_cast<VertexFormat>(header.vertexFormat);
+    indices = reinterpret_cast<const unsigned int*>(p + vertexBytes);
+    vertexCount = header.vertexCount;
+    indexCount = header.indexCount;
+    boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+#include "MappedFile.h"
+
+// 二进制网格缓存（.meshbin）
+// 保存 OBJ 解析后的最终结果：交错的顶点数组（Vertex 或 PackedVertex）、索引缓冲、包围盒和子网格范围。
+// 文件布局（小端，全部 4 字节对齐）：
+//   MeshCacheHeader
+//   MeshCacheSubMesh[subMeshCount]
+//   char[stringBytes]（子网格组名/材质名）
+//   Vertex[vertexCount] 或 PackedVertex[vertexCount]（由 vertexFormat 决定）
+//   uint32_t[indexCount]
+// 加载时直接映射文件，把顶点/索引区域的指针交给 glBufferData，不做任何逐顶点处理。
+
+// 源文件标识：大小、修改时间和内容哈希任一变化都会使缓存失效
+// buildFlags 记录生成缓存时的处理选项（例如网格优化开关），选项不同的缓存同样视为过期
+struct MeshCacheSource {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;
+    uint32_t buildFlags = 0;
+};
+
+// 计算源文件标识（data/size 为已映射的源文件内容）
+MeshCacheSource MakeMeshCacheSource(const std::string& path, const char* data, size_t size);
+
+// 64 位内容哈希（每次处理 8 字节）
+uint64_t HashBytes(const void* data, size_t size);
+
+// 源文件对应的缓存路径（models/foo.obj -> models/foo.obj.meshbin）
+std::string GetMeshCachePath(const std::string& sourcePath);
+
+// 写入缓存（先写临时文件再重命名，避免留下不完整的缓存）
+// 任一子网格的索引加 baseVertex 超出顶点数时不写入，返回 false
+bool WriteMeshCache(const std::string& cachePath, const MeshCacheSource& source,
+                    const void* vertexData, size_t vertexCount, VertexFormat format,
+                    const std::vector<unsigned int>& indices,
+                    const std::vector<SubMesh>& subMeshes,
+                    const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+// 只读缓存视图：Open 成功后，各指针直接指向映射内存，生命周期与对象相同
+class MeshCacheReader {
+public:
+    // 打开并校验缓存（魔数、版本、顶点布局、源文件标识、文件长度、子网格的索引区间和 baseVertex）
+    // 索引本身的范围在写入时校验；任一项不通过时返回 false，调用方改为解析 OBJ 并重写缓存
+    bool Open(const std::string& cachePath, const MeshCacheSource& source);
+
+    const void* Vertices() const { return vertices; }
+    VertexFormat Format() const { return format; }
+    const unsigned int* Indices() const { return indices; }
+    size_t VertexCount() const { return vertexCount; }
+    size_t IndexCount() const { return indexCount; }
+    const std::vector<SubMesh>& SubMeshes() const { return subMeshes; }
+    glm::vec3 BoundsMin() const { return boundsMin; }
+    glm::vec3 BoundsMax() const { return boundsMax; }
+
+private:
+    MappedFile file;
+    const void* vertices = nullptr;
+    VertexFormat format = VertexFormat::Float;
+    const unsigned int* indices = nullptr;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    std::vector<SubMesh> subMeshes;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+};
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,243 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+const unsigned int kNone = 0xFFFFFFFFu;
+
+// FIFO 缓存模拟：顶点在 cacheSize 次未命中内被写入过即视为命中
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, unsigned int cacheSize)
+        : insertedAt(vertexCount, 0), cacheSize(cacheSize), clock(cacheSize) {}
+
+    // 访问顶点，未命中时返回 true
+    bool Access(unsigned int v) {
+        if (clock - insertedAt[v] < cacheSize) return false;
+        insertedAt[v] = ++clock;
+        return true;
+    }
+
+    // 清空缓存（所有顶点都被挤出）
+    void Reset() { clock += cacheSize; }
+
+private:
+    std::vector<uint64_t> insertedAt;
+    uint64_t cacheSize;
+    uint64_t clock;
+};
+
+} // namespace
+
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                    unsigned int cacheSize) {
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+    if (stats.triangles == 0 || vertexCount == 0) return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    for (size_t i = 0; i < stats.triangles * 3; ++i) {
+        if (cache.Access(indices[i])) ++stats.misses;
+    }
+    stats.acmr = static_cast<float>(stats.misses) / static_cast<float>(stats.triangles);
+    stats.atvr = static_cast<float>(stats.misses) / static_cast<float>(vertexCount);
+    return stats;
+}
+
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount,
+                         unsigned int cacheSize, std::vector<unsigned int>* clusters) {
+    const size_t triangleCount = indexCount / 3;
+    if (clusters) {
+        clusters->clear();
+        clusters->push_back(0);
+    }
+    if (triangleCount == 0 || vertexCount == 0) return;
+
+    // 顶点 -> 三角形邻接表（CSR），liveTriangles 为尚未输出的相邻三角形数
+    std::vector<unsigned int> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) ++liveTriangles[indices[i]];
+
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    {
+        std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int c = 0; c < 3; ++c) adjacency[fill[indices[t * 3 + c]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<uint64_t> cacheTime(vertexCount, 0);
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<unsigned int> deadEnd;
+    deadEnd.reserve(triangleCount * 3);
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+
+    uint64_t timestamp = cacheSize + 1;
+    size_t cursor = 1;         // 顺序扫描的下一个起点
+    unsigned int fan = 0;      // 当前扇形中心顶点
+
+    while (fan != kNone) {
+        // 输出以 fan 为中心的所有剩余三角形
+        candidates.clear();
+        for (unsigned int k = adjacencyOffset[fan]; k < adjacencyOffset[fan + 1]; ++k) {
+            const unsigned int t = adjacency[k];
+            if (emitted[t]) continue;
+            for (int c = 0; c < 3; ++c) {
+                const unsigned int v = indices[t * 3 + c];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --liveTriangles[v];
+                if (timestamp - cacheTime[v] > cacheSize) cacheTime[v] = timestamp++;
+            }
+            emitted[t] = 1;
+        }
+
+        // 选下一个扇形中心：优先选择输出其剩余三角形后仍留在缓存里、且最早进入缓存的顶点
+        unsigned int next = kNone;
+        int64_t bestPriority = -1;
+        for (unsigned int v : candidates) {
+            if (liveTriangles[v] == 0) continue;
+            int64_t priority = 0;
+            const int64_t age = static_cast<int64_t>(timestamp - cacheTime[v]);
+            if (age + 2 * static_cast<int64_t>(liveTriangles[v]) <= static_cast<int64_t>(cacheSize)) priority = age;
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        // 死胡同：先回溯最近输出过的顶点，再顺序扫描（此时形成硬边界）
+        if (next == kNone) {
+            while (!deadEnd.empty()) {
+                const unsigned int d = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[d] > 0) {
+                    next = d;
+                    break;
+                }
+            }
+        }
+        if (next == kNone) {
+            while (cursor < vertexCount && liveTriangles[cursor] == 0) ++cursor;
+            if (cursor < vertexCount) {
+                next = static_cast<unsigned int>(cursor);
+                const unsigned int boundary = static_cast<unsigned int>(output.size() / 3);
+                if (clusters && clusters->back() != boundary) clusters->push_back(boundary);
+            }
+        }
+        fan = next;
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                      const std::vector<unsigned int>& clusters, float threshold, unsigned int cacheSize) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || vertexCount == 0) return;
+
+    // 软边界：在每个硬簇内从头模拟一个空缓存，局部 ACMR 降到阈值以内即可切开，
+    // 保证簇被重新排序后缓存效率不会明显下降
+    const float targetAcmr = AnalyzeVertexCache(indices, triangleCount * 3, vertexCount, cacheSize).acmr * threshold;
+    const std::vector<unsigned int> hardStarts = clusters.empty() ? std::vector<unsigned int>(1, 0u) : clusters;
+    std::vector<unsigned int> starts;
+    FifoCache cache(vertexCount, cacheSize);
+    for (size_t c = 0; c < hardStarts.size(); ++c) {
+        const size_t begin = hardStarts[c];
+        const size_t end = (c + 1 < hardStarts.size()) ? hardStarts[c + 1] : triangleCount;
+        size_t start = begin;
+        size_t misses = 0;
+        cache.Reset();
+        for (size_t t = begin; t < end; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                if (cache.Access(indices[t * 3 + k])) ++misses;
+            }
+            if (t + 1 < end && static_cast<float>(misses) <= targetAcmr * static_cast<float>(t + 1 - start)) {
+                starts.push_back(static_cast<unsigned int>(start));
+                start = t + 1;
+                misses = 0;
+                cache.Reset();
+            }
+        }
+        if (start < end) starts.push_back(static_cast<unsigned int>(start));
+    }
+    if (starts.size() < 2) return;
+
+    // 网格中心（面积加权）
+    glm::dvec3 centroidSum(0.0);
+    double areaSum = 0.0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const glm::vec3& a = vertices[indices[t * 3 + 0]].Pos;
+        const glm::vec3& b = vertices[indices[t * 3 + 1]].Pos;
+        const glm::vec3& c = vertices[indices[t * 3 + 2]].Pos;
+        const double area = glm::length(glm::cross(b - a, c - a));
+        centroidSum += glm::dvec3(a + b + c) * (area / 3.0);
+        areaSum += area;
+    }
+    const glm::dvec3 meshCentroid = areaSum > 0.0 ? centroidSum / areaSum : glm::dvec3(0.0);
+
+    // 每个簇的朝外程度：dot(簇中心 - 网格中心, 簇平均法线)
+    struct ClusterKey {
+        double sortKey;
+        unsigned int begin;
+        unsigned int end;
+    };
+    std::vector<ClusterKey> keys(starts.size());
+    for (size_t c = 0; c < starts.size(); ++c) {
+        const size_t begin = starts[c];
+        const size_t end = (c + 1 < starts.size()) ? starts[c + 1] : triangleCount;
+        glm::dvec3 clusterCentroid(0.0);
+        glm::dvec3 clusterNormal(0.0);
+        double clusterArea = 0.0;
+        for (size_t t = begin; t < end; ++t) {
+            const glm::vec3& a = vertices[indices[t * 3 + 0]].Pos;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].Pos;
+            const glm::vec3& cc = vertices[indices[t * 3 + 2]].Pos;
+            const glm::dvec3 n = glm::dvec3(glm::cross(b - a, cc - a));
+            const double area = glm::length(n);
+            clusterCentroid += glm::dvec3(a + b + cc) * (area / 3.0);
+            clusterNormal += n;
+            clusterArea += area;
+        }
+        double sortKey = 0.0;
+        const double normalLength = glm::length(clusterNormal);
+        if (clusterArea > 0.0 && normalLength > 0.0) {
+            sortKey = glm::dot(clusterCentroid / clusterArea - meshCentroid, clusterNormal / normalLength);
+        }
+        keys[c] = ClusterKey{ sortKey, static_cast<unsigned int>(begin), static_cast<unsigned int>(end) };
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+        [](const ClusterKey& a, const ClusterKey& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<unsigned int> reordered;
+    reordered.reserve(triangleCount * 3);
+    for (const ClusterKey& key : keys) {
+        reordered.insert(reordered.end(), indices + key.begin * 3, indices + key.end * 3);
+    }
+    std::copy(reordered.begin(), reordered.end(), indices);
+}
+
+void OptimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount) {
+    if (vertexCount == 0) return;
+
+    std::vector<unsigned int> remap(vertexCount, kNone);
+    unsigned int nextIndex = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        unsigned int& slot = remap[indices[i]];
+        if (slot == kNone) slot = nextIndex++;
+        indices[i] = slot;
+    }
+    for (auto& slot : remap) {
+        if (slot == kNone) slot = nextIndex++;
+    }
+
+    std::vector<Vertex> reordered(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) reordered[remap[v]] = vertices[v];
+    std::copy(reordered.begin(), reordered.end(), vertices);
+}
@@ -0,0 +1,38 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+#include "Mesh.h"
+
+// 加载阶段的网格优化（索引均为三角形列表，相对于传入的顶点数组）
+// 推荐顺序：OptimizeVertexCache -> OptimizeOverdraw（可选）-> OptimizeVertexFetch
+
+// 顶点缓存模拟结果（FIFO 缓存）
+struct VertexCacheStats {
+    float acmr = 0.0f;  // 平均每个三角形的缓存未命中数（3.0 为最差，理想约 0.5~0.7）
+    float atvr = 0.0f;  // 未命中数 / 顶点数（1.0 为理想值）
+    size_t misses = 0;
+    size_t triangles = 0;
+};
+
+// 在 CPU 上模拟 cacheSize 大小的 FIFO 后变换缓存，无需 GPU 即可度量索引顺序
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                     unsigned int cacheSize = 16);
+
+// Tipsify 三角形重排（Sander et al. 2007，线性时间）
+// clusters 非空时输出硬边界（算法不得不跳到不相邻区域处）的三角形起始序号，供 OptimizeOverdraw 使用
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount,
+                         unsigned int cacheSize = 16, std::vector<unsigned int>* clusters = nullptr);
+
+// 过度绘制优化：在硬边界内再按 ACMR 阈值切出软边界，
+// 然后按簇朝外程度（簇中心相对网格中心在簇法线方向上的投影）从大到小排序，让外侧表面先绘制
+// threshold 为允许的 ACMR 相对上升比例（1.05 表示最多变差 5%）
+void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                      const std::vector<unsigned int>& clusters, float threshold = 1.05f,
+                      unsigned int cacheSize = 16);
+
+// 按首次使用顺序重排顶点并重写索引，提高顶点读取的局部性（未被引用的顶点放在末尾）
+void OptimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount);
+
+#endif // MESH_OPTIMIZER_H
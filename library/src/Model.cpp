@@ -1,154 +1,217 @@
 #include "Model.h"
 #include "Mesh.h"
-#include <fstream>
-#include <sstream>
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "VertexPacking.h"
+#include "ObjParser.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cstring>
 #include <glm/glm.hpp>
 
-Model::Model(const std::string& path) {
+namespace {
+
+const unsigned int kNoIndex = 0xFFFFFFFFu;
+
+// 面角点的 (v, vt, vn) 三元组
+struct CornerKey {
+    unsigned int v, t, n;
+    bool operator==(const CornerKey& o) const { return v == o.v && t == o.t && n == o.n; }
+};
+
+inline uint64_t MixHash(uint64_t h) {
+    // splitmix64 终结函数
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+inline uint64_t HashCorner(const CornerKey& k) {
+    return MixHash((static_cast<uint64_t>(k.v) << 32 | k.t) ^ (static_cast<uint64_t>(k.n) * 0x9E3779B97F4A7C15ULL));
+}
+
+inline uint64_t HashVertex(const Vertex& v) {
+    uint32_t words[sizeof(Vertex) / sizeof(uint32_t)];
+    std::memcpy(words, &v, sizeof(Vertex));
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint32_t w : words) h = MixHash(h ^ w);
+    return h;
+}
+
+// 开放寻址哈希表（线性探测），槽位中保存已焊接顶点的下标
+class WeldTable {
+public:
+    explicit WeldTable(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity <<= 1;
+        slots.assign(capacity, kNoIndex);
+        mask = capacity - 1;
+    }
+
+    // 查找与 equal 匹配的顶点；不存在时以 newIndex 插入并返回 true
+    template <typename Equal>
+    bool FindOrInsert(uint64_t hash, unsigned int newIndex, unsigned int& outIndex, Equal equal) {
+        size_t slot = static_cast<size_t>(hash) & mask;
+        while (slots[slot] != kNoIndex) {
+            if (equal(slots[slot])) {
+                outIndex = slots[slot];
+                return false;
+            }
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = newIndex;
+        outIndex = newIndex;
+        return true;
+    }
+
+private:
+    std::vector<unsigned int> slots;
+    size_t mask;
+};
+
+// 按顶点内容（逐位比较）合并完全相同的顶点，并重写索引
+void WeldIdenticalVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    std::vector<Vertex> unique;
+    unique.reserve(vertices.size());
+    std::vector<unsigned int> remap(vertices.size());
+    WeldTable table(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertex& v = vertices[i];
+        unsigned int index = 0;
+        const bool inserted = table.FindOrInsert(HashVertex(v), static_cast<unsigned int>(unique.size()), index,
+            [&](unsigned int candidate) { return std::memcmp(&unique[candidate], &v, sizeof(Vertex)) == 0; });
+        if (inserted) unique.push_back(v);
+        remap[i] = index;
+    }
+
+    for (auto& idx : indices) idx = remap[idx];
+    vertices.swap(unique);
+}
+
+// 优化时模拟的后变换缓存大小
+const unsigned int kVertexCacheSize = 16;
+
+// 逐子网格优化索引顺序和顶点顺序（顶点只在子网格自己的范围内移动），
+// before/after 为所有子网格合计的缓存模拟结果
+void OptimizeSubMeshes(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                       const std::vector<SubMesh>& subMeshes, const ModelLoadOptions& options,
+                       VertexCacheStats& before, VertexCacheStats& after) {
+    std::vector<unsigned int> clusters;
+    for (size_t s = 0; s < subMeshes.size(); s++) {
+        const SubMesh& sub = subMeshes[s];
+        const size_t vertexBegin = static_cast<size_t>(sub.baseVertex);
+        const size_t vertexEnd = (s + 1 < subMeshes.size()) ? static_cast<size_t>(subMeshes[s + 1].baseVertex) : vertices.size();
+        Vertex* subVertices = vertices.data() + vertexBegin;
+        const size_t subVertexCount = vertexEnd - vertexBegin;
+        unsigned int* subIndices = indices.data() + sub.indexOffset;
+
+        const VertexCacheStats original = AnalyzeVertexCache(subIndices, sub.indexCount, subVertexCount, kVertexCacheSize);
+        before.misses += original.misses;
+        before.triangles += original.triangles;
+
+        OptimizeVertexCache(subIndices, sub.indexCount, subVertexCount, kVertexCacheSize,
+                            options.optimizeOverdraw ? &clusters : nullptr);
+        if (options.optimizeOverdraw) {
+            OptimizeOverdraw(subIndices, sub.indexCount, subVertices, subVertexCount, clusters,
+                             options.overdrawThreshold, kVertexCacheSize);
+        }
+        OptimizeVertexFetch(subVertices, subVertexCount, subIndices, sub.indexCount);
+
+        const VertexCacheStats optimized = AnalyzeVertexCache(subIndices, sub.indexCount, subVertexCount, kVertexCacheSize);
+        after.misses += optimized.misses;
+        after.triangles += optimized.triangles;
+    }
+
+    for (VertexCacheStats* stats : { &before, &after }) {
+        stats->acmr = stats->triangles > 0 ? static_cast<float>(stats->misses) / static_cast<float>(stats->triangles) : 0.0f;
+        stats->atvr = !vertices.empty() ? static_cast<float>(stats->misses) / static_cast<float>(vertices.size()) : 0.0f;
+    }
+}
+
+// 影响缓存内容的加载选项的指纹，写入 MeshCacheSource::buildFlags
+uint32_t GetCacheBuildFlags(const ModelLoadOptions& options) {
+    uint64_t h = 0;
+    auto mix = [&h](uint64_t value) { h = MixHash(h ^ value); };
+    auto floatBits = [](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<uint64_t>(bits);
+    };
+    mix(options.optimizeVertexCache);
+    mix(options.optimizeOverdraw);
+    mix(floatBits(options.overdrawThreshold));
+    mix(options.packVertices);
+    mix(floatBits(options.packedTexCoordTolerance));
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+} // namespace
+
+Model::Model(const std::string& path, const ModelLoadOptions& options)
+    : loadOptions(options) {
     loadOBJ(path);
 }
 
-void Model::Draw(Shader& shader) {
+void Model::Draw(Shader& shader, const glm::mat4& model) {
     for (unsigned int i = 0; i < meshes.size(); i++) {
-        meshes[i].Draw(shader);
+        meshes[i].Draw(shader, model);
     }
 }
 
-// 彻底修复的OBJ解析逻辑（重点：法线索引提取 + 纹理坐标解析）
+void Model::MoveToArena(GeometryArena& arena) {
+    for (Mesh& mesh : meshes) {
+        mesh.MoveToArena(arena);
+    }
+}
+
+// OBJ 加载：内存映射文件 + 原地分词解析（见 ObjParser），随后构建顶点数据
 void Model::loadOBJ(const std::string& path) {
-    std::vector<glm::vec3> temp_vertices;  // 临时顶点位置
-    std::vector<glm::vec2> temp_texCoords; // 临时纹理坐标
-    std::vector<glm::vec3> temp_normals;   // 临时法线
-    std::vector<unsigned int> vIndices, tIndices, nIndices;  // 顶点/纹理/法线索引
+    const auto parseStart = std::chrono::steady_clock::now();
 
-    std::ifstream file(path);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.Open(path)) {
         std::cerr << "ERROR::MODEL::FILE_OPEN_FAILED: " << path << std::endl;
         return;  
     }
 
+    // 源文件标识（大小 + 修改时间 + 内容哈希），用于校验/写入二进制缓存
+    MeshCacheSource cacheSource;
+    if (loadOptions.useBinaryCache) {
+        cacheSource = MakeMeshCacheSource(path, file.Data(), file.Size());
+        cacheSource.buildFlags = GetCacheBuildFlags(loadOptions);
+        if (loadFromCache(path, cacheSource)) {
+            return;
+        }
+    }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+    // 大文件使用并行解析
+    const bool parallel = loadOptions.parallelParse && file.Size() >= loadOptions.parallelMinBytes;
+    const unsigned int parseThreads = parallel ? loadOptions.parseThreads : 1;
 
-        // 1. 解析顶点位置（v x y z）
-        if (type == "v") {
-            glm::vec3 v;
-            iss >> v.x >> v.y >> v.z;
-            temp_vertices.push_back(v);
-        }
-        // 2. 解析纹理坐标（vt u v）
-        else if (type == "vt") {
-            glm::vec2 vt;
-            iss >> vt.x >> vt.y;
-            temp_texCoords.push_back(vt);
-        }
-        // 3. 解析法线（vn x y z）
-        else if (type == "vn") {
-            glm::vec3 n;
-            iss >> n.x >> n.y >> n.z;
-            temp_normals.push_back(n);
-        }
-        // 4. 解析面（支持多种格式：f v1 v2 v3 或 f v1/vt1 v2/vt2 v3/vt3 或 f v1//vn1 或 f v1/vt1/vn1）
-        else if (type == "f") {
-            std::string vertexStr;
-            std::vector<std::string> faceVertices;
-            
-            // 读取面的所有顶点（不假设只有3个，但只处理前3个）
-            while (iss >> vertexStr) {
-                faceVertices.push_back(vertexStr);
-            }
-            
-            // 只处理三角形面（至少3个顶点）
-            if (faceVertices.size() < 3) {
-                std::cerr << "WARNING::MODEL::INVALID_FACE: face has less than 3 vertices in " << path << std::endl;
-                continue;
-            }
-            
-            // 处理前3个顶点（如果是多边形，只取前3个构成三角形）
-            for (int i = 0; i < 3; i++) {
-                std::istringstream vss(faceVertices[i]);
-                std::string part;
-                unsigned int vIdx = 0;
-                bool hasTexIndex = false;
-                unsigned int tIdx = 0;
-                bool hasNormalIndex = false;
-                unsigned int nIdx = 0;
-
-                // 分割逻辑：处理多种格式
-                // "v" 或 "v/vt" 或 "v//vn" 或 "v/vt/vn"
-                int partCount = 0;
-                while (std::getline(vss, part, '/')) {
-                    partCount++;
-                    if (partCount == 1 && !part.empty()) {  // 第一个部分：顶点索引
-                        try {
-                            vIdx = std::stoi(part) - 1;  // OBJ索引1→0
-                        } catch (const std::exception& e) {
-                            std::cerr << "WARNING::MODEL::INVALID_VERTEX_FORMAT: " << part << " in " << path << std::endl;
-                            vIdx = 0;
-                        }
-                    }
-                    else if (partCount == 2 && !part.empty()) {  // 第二个部分：纹理坐标索引
-                        try {
-                            tIdx = std::stoi(part) - 1;
-                            hasTexIndex = true;
-                        } catch (const std::exception& e) {
-                            // 无法解析纹理坐标索引，忽略
-                        }
-                    }
-                    else if (partCount == 3 && !part.empty()) {  // 第三个部分：法线索引
-                        try {
-                            nIdx = std::stoi(part) - 1;
-                            hasNormalIndex = true;
-                        } catch (const std::exception& e) {
-                            // 无法解析法线索引，忽略
-                        }
-                    }
-                }
+    ObjData obj;
+    ParseOBJ(file.Data(), file.Size(), obj, path, parseThreads);
+    const size_t fileSize = file.Size();
+    file.Close();
 
-                // 验证顶点索引是否有效
-                if (vIdx >= temp_vertices.size()) {
-                    std::cerr << "WARNING::MODEL::INVALID_VERTEX_INDEX: " << vIdx << " (max: " << temp_vertices.size() - 1 << ") in " << path << std::endl;
-                    continue;
-                }
-                
-                vIndices.push_back(vIdx);
-                
-                // 如果有纹理坐标索引，验证并保存
-                if (hasTexIndex) {
-                    if (tIdx >= temp_texCoords.size()) {
-                        std::cerr << "WARNING::MODEL::INVALID_TEXCOORD_INDEX: " << tIdx << " (max: " << temp_texCoords.size() - 1 << ") in " << path << std::endl;
-                        tIndices.push_back(0);  // 占位符
-                    } else {
-                        tIndices.push_back(tIdx);
-                    }
-                } else {
-                    // 没有纹理坐标索引，添加占位符
-                    tIndices.push_back(0);  // 占位符，后续会用默认值或生成
-                }
-                
-                // 如果有法线索引，验证并保存
-                if (hasNormalIndex) {
-                    if (nIdx >= temp_normals.size()) {
-                        std::cerr << "WARNING::MODEL::INVALID_NORMAL_INDEX: " << nIdx << " (max: " << temp_normals.size() - 1 << ") in " << path << std::endl;
-                        nIndices.push_back(0);  // 占位符
-                    } else {
-                        nIndices.push_back(nIdx);
-                    }
-                } else {
-                    // 没有法线索引，添加占位符
-                    nIndices.push_back(0);  // 占位符
-                }
-            }
-        }
-    }
-    file.close();
+    const double parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parseStart).count();
+    const double fileMB = static_cast<double>(fileSize) / (1024.0 * 1024.0);
+    std::cout << "MODEL::LOADED: " << path << " | Parsed " << fileMB << " MB in " << parseMs << " ms ("
+              << (parseMs > 0.0 ? fileMB * 1000.0 / parseMs : 0.0) << " MB/s, "
+              << (parallel ? "parallel" : "single-threaded") << ")" << std::endl;
+
+    const std::vector<glm::vec3>& temp_vertices = obj.positions;   // 临时顶点位置
+    const std::vector<glm::vec2>& temp_texCoords = obj.texCoords;  // 临时纹理坐标
+    const std::vector<glm::vec3>& temp_normals = obj.normals;      // 临时法线
+    const std::vector<unsigned int>& vIndices = obj.vIndices;      // 顶点/纹理/法线索引
+    const std::vector<unsigned int>& tIndices = obj.tIndices;
+    const std::vector<unsigned int>& nIndices = obj.nIndices;
 
     // 检查是否有法线数据
     bool hasNormals = !temp_normals.empty() && !nIndices.empty();
@@ -187,8 +250,9 @@ void Model::loadOBJ(const std::string& path) {
                   << "), nIndices(" << nIndices.size() << ") have different sizes in " << path << std::endl;
         return;
     }
-    
-    for (unsigned int i = 0; i < vIndices.size(); i++) {
+
+    // 按角点构建顶点（法线缺失时先置零，稍后计算）
+    auto buildVertex = [&](size_t i) {
         Vertex vert;
         vert.Pos = temp_vertices[vIndices[i]];
         
@@ -206,15 +270,87 @@ void Model::loadOBJ(const std::string& path) {
             // 如果没有纹理坐标，使用顶点位置的 XY 作为简单的 UV 映射（适用于简单几何体）
             vert.TexCoords = glm::vec2(vert.Pos.x, vert.Pos.y);
         }
-        
-        vertices.push_back(vert);
-        indices.push_back(i);
+        return vert;
+    };
+
+    // 按 g/usemtl 分组构建子网格：所有子网格共用一个 VBO/EBO，
+    // 每个子网格的索引相对于自己的 baseVertex，绘制时用 glDrawElementsBaseVertex
+    std::vector<SubMesh> subMeshes;
+    std::vector<unsigned int> triCorners;  // 当前分组三角化后的角点下标（每 3 个一组）
+    std::vector<Vertex> subVertices;
+    std::vector<unsigned int> subIndices;
+    std::vector<CornerKey> uniqueKeys;
+    size_t triangleCornerCount = 0;
+
+    for (const ObjGroup& group : obj.groups) {
+        // 多边形三角化（耳切，凹多边形也能正确处理）
+        triCorners.clear();
+        size_t corner = group.cornerBegin;
+        for (size_t f = group.faceBegin; f < group.faceEnd; f++) {
+            TriangulateFace(obj, corner, obj.faceSizes[f], triCorners);
+            corner += obj.faceSizes[f];
+        }
+        if (triCorners.empty()) continue;
+        triangleCornerCount += triCorners.size();
+
+        subVertices.clear();
+        subIndices.clear();
+        if (hasNormals) {
+            // 顶点焊接：相同 (v, vt, vn) 三元组的角点共用一个顶点，EBO 成为真正的索引
+            // 无效/缺失的 vt、vn 统一映射为 kNoIndex，与上面 buildVertex 的回退规则一致
+            uniqueKeys.clear();
+            WeldTable table(triCorners.size());
+
+            for (unsigned int i : triCorners) {
+                CornerKey key;
+                key.v = vIndices[i];
+                key.t = (hasTexCoords && tIndices[i] < temp_texCoords.size()) ? tIndices[i] : kNoIndex;
+                key.n = (nIndices[i] < temp_normals.size()) ? nIndices[i] : kNoIndex;
+
+                const unsigned int newIndex = static_cast<unsigned int>(subVertices.size());
+                unsigned int index = 0;
+                const bool inserted = table.FindOrInsert(HashCorner(key), newIndex, index,
+                    [&](unsigned int candidate) { return uniqueKeys[candidate] == key; });
+                if (inserted) {
+                    uniqueKeys.push_back(key);
+                    subVertices.push_back(buildVertex(i));
+                }
+                subIndices.push_back(index);
+            }
+        } else {
+            // 无法线：先逐角点展开并计算面法线（保持平直着色），再按顶点内容焊接
+            for (unsigned int i : triCorners) {
+                subIndices.push_back(static_cast<unsigned int>(subVertices.size()));
+                subVertices.push_back(buildVertex(i));
+            }
+            calculateNormals(subVertices, subIndices);
+            WeldIdenticalVertices(subVertices, subIndices);
+        }
+
+        SubMesh sub;
+        sub.indexOffset = static_cast<unsigned int>(indices.size());
+        sub.indexCount = static_cast<unsigned int>(subIndices.size());
+        sub.baseVertex = static_cast<int>(vertices.size());
+        sub.name = group.name;
+        sub.material = group.material;
+        subMeshes.push_back(sub);
+
+        vertices.insert(vertices.end(), subVertices.begin(), subVertices.end());
+        indices.insert(indices.end(), subIndices.begin(), subIndices.end());
+    }
+    
+    // 顶点缓存 / 过度绘制 / 顶点读取顺序优化（结果写入 .meshbin，之后的加载不再重复计算）
+    if (loadOptions.optimizeVertexCache && !indices.empty()) {
+        VertexCacheStats before, after;
+        OptimizeSubMeshes(vertices, indices, subMeshes, loadOptions, before, after);
+        std::cout << "MODEL::LOADED: " << path << " | Vertex cache (FIFO " << kVertexCacheSize << ") ACMR: "
+                  << before.acmr << " -> " << after.acmr << ", ATVR: " << before.atvr << " -> " << after.atvr
+                  << (loadOptions.optimizeOverdraw ? " (overdraw ordered)" : "") << std::endl;
     }
     
-    // 如果无法线数据，自动计算
+    // 如果无法线数据，已在上面自动计算
     if (!hasNormals) {
         if (!vertices.empty() && !indices.empty()) {
-            calculateNormals(vertices, indices);
             std::cout << "MODEL::LOADED: " << path << " | Normals calculated automatically" << std::endl;
         }
     } else {
@@ -227,8 +363,96 @@ void Model::loadOBJ(const std::string& path) {
         std::cout << "MODEL::LOADED: " << path << " | Generated texture coordinates from vertex positions" << std::endl;
     }
 
-    std::cout << "MODEL::LOADED: " << path << " | Vertices: " << vertices.size() << ", Indices: " << indices.size() << std::endl;
-    meshes.push_back(Mesh(vertices, indices));
+    std::cout << "MODEL::LOADED: " << path << " | Faces: " << obj.faceSizes.size() << " -> "
+              << triangleCornerCount / 3 << " triangles, SubMeshes: " << subMeshes.size() << std::endl;
+    std::cout << "MODEL::LOADED: " << path << " | Vertices: " << triangleCornerCount << " -> " << vertices.size()
+              << " (welded), Indices: " << indices.size() << std::endl;
+
+    if (!vertices.empty()) {
+        boundsMin = boundsMax = vertices[0].Pos;
+        for (const auto& v : vertices) {
+            boundsMin = glm::min(boundsMin, v.Pos);
+            boundsMax = glm::max(boundsMax, v.Pos);
+        }
+    }
+
+    // 顶点压缩：逐顶点解码并与原始数据比较，误差超出上界时保留浮点格式
+    std::vector<PackedVertex> packed;
+    const glm::vec3 posScale = GetPositionScale(boundsMin, boundsMax);
+    if (loadOptions.packVertices && !vertices.empty()) {
+        PackVertices(vertices.data(), vertices.size(), boundsMin, boundsMax, packed);
+        const PackingError error = MeasurePackingError(vertices.data(), packed.data(), vertices.size(), posScale, boundsMin);
+        const float positionError = std::max(error.position.x, std::max(error.position.y, error.position.z));
+        if (IsPackingErrorAcceptable(error, posScale, boundsMin, loadOptions.packedTexCoordTolerance)) {
+            std::cout << "MODEL::LOADED: " << path << " | Packed vertices (" << sizeof(PackedVertex) << " bytes): max error position "
+                      << positionError << ", normal " << error.normalDegrees << " deg, texcoord " << error.texCoord << std::endl;
+        } else {
+            std::cerr << "WARNING::MODEL::PACKING_ERROR: " << path << " | position " << positionError
+                      << ", normal " << error.normalDegrees << " deg, texcoord " << error.texCoord
+                      << " exceed bounds, keeping float vertices" << std::endl;
+            packed.clear();
+        }
+    }
+
+    // 先写缓存，再把几何数据移动进 Mesh（避免额外复制）
+    if (loadOptions.useBinaryCache) {
+        const std::string cachePath = GetMeshCachePath(path);
+        const bool cachePacked = !packed.empty();
+        const void* vertexData = cachePacked ? static_cast<const void*>(packed.data()) : static_cast<const void*>(vertices.data());
+        if (WriteMeshCache(cachePath, cacheSource, vertexData, vertices.size(),
+                           cachePacked ? VertexFormat::Packed : VertexFormat::Float,
+                           indices, subMeshes, boundsMin, boundsMax)) {
+            std::cout << "MODEL::LOADED: " << path << " | Wrote binary cache " << cachePath << std::endl;
+        }
+    }
+
+    if (!packed.empty()) {
+        meshes.emplace_back(packed.data(), packed.size(), VertexFormat::Packed, posScale, boundsMin,
+                            indices.data(), indices.size(), std::move(subMeshes));
+    } else {
+        meshes.emplace_back(std::move(vertices), std::move(indices), std::move(subMeshes));
+        if (loadOptions.gpuOnly) {
+            meshes.back().ReleaseCpuGeometry();
+        }
+    }
+    logMemory(path);
+}
+
+// 从 .meshbin 缓存加载：映射文件后把顶点/索引区域直接交给 glBufferData
+bool Model::loadFromCache(const std::string& path, const MeshCacheSource& source) {
+    const auto loadStart = std::chrono::steady_clock::now();
+
+    MeshCacheReader reader;
+    if (!reader.Open(GetMeshCachePath(path), source)) {
+        return false;
+    }
+
+    boundsMin = reader.BoundsMin();
+    boundsMax = reader.BoundsMax();
+    // 压缩顶点的反量化参数由包围盒推出，与写入时的计算完全相同
+    const bool packed = reader.Format() == VertexFormat::Packed;
+    meshes.emplace_back(reader.Vertices(), reader.VertexCount(), reader.Format(),
+                        packed ? GetPositionScale(boundsMin, boundsMax) : glm::vec3(1.0f),
+                        packed ? boundsMin : glm::vec3(0.0f),
+                        reader.Indices(), reader.IndexCount(), reader.SubMeshes());
+
+    const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    std::cout << "MODEL::LOADED: " << path << " | Loaded from cache in " << loadMs << " ms (Vertices: "
+              << reader.VertexCount() << ", Indices: " << reader.IndexCount() << ")" << std::endl;
+    logMemory(path);
+    return true;
+}
+
+// 输出本模型的几何内存：GPU 缓冲大小、仍驻留的 CPU 副本
+void Model::logMemory(const std::string& path) const {
+    size_t gpuBytes = 0;
+    size_t cpuBytes = 0;
+    for (const Mesh& mesh : meshes) {
+        gpuBytes += mesh.GetGpuBytes();
+        cpuBytes += mesh.GetCpuBytes();
+    }
+    std::cout << "MODEL::LOADED: " << path << " | Memory: GPU " << gpuBytes / 1024 << " KB, CPU resident "
+              << cpuBytes / 1024 << " KB" << std::endl;
 }
 
 // 自动计算法线：当 OBJ 文件没有法线数据时使用
@@ -4,21 +4,56 @@
 #include <string>
 #include <vector>
 #include "Mesh.h"  // 必须包含 Mesh.h（Model 包含 Mesh）
+#include "MeshCache.h"
+
+// 模型加载选项
+struct ModelLoadOptions {
+    // 并行解析：大文件按行切块后在线程池上并行解析（小于 parallelMinBytes 的文件仍单线程）
+    bool parallelParse = true;
+    unsigned int parseThreads = 0;        // 0 表示使用全部硬件线程
+    size_t parallelMinBytes = 4u << 20;   // 4 MB
+
+    // 二进制缓存：首次解析后写入 <path>.meshbin，之后直接映射加载（源文件变化时自动重建）
+    bool useBinaryCache = true;
+
+    // 网格优化（结果随缓存保存）：Tipsify 三角形重排 + 首次使用顶点重排，可选过度绘制簇排序
+    bool optimizeVertexCache = true;
+    bool optimizeOverdraw = true;
+    float overdrawThreshold = 1.05f;      // 过度绘制排序允许的 ACMR 相对上升比例
+
+    // 压缩顶点（16 字节，见 VertexPacking.h）：加载时逐顶点解码校验误差，超出上界时保留 32 字节浮点格式
+    bool packVertices = true;
+    float packedTexCoordTolerance = 1.0f / 1024.0f;  // 半精度 UV 允许的最大绝对误差
+
+    // GPU-only：上传后释放 CPU 端顶点/索引（压缩顶点和缓存加载的网格本来就不保留 CPU 副本）
+    bool gpuOnly = false;
+};
 
 class Model {
 public:
     std::vector<Mesh> meshes;
 
+    // 模型空间包围盒
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
     // 构造函数声明
-    Model(const std::string& path);
+    Model(const std::string& path, const ModelLoadOptions& options = ModelLoadOptions());
 
-    // 绘制函数声明
-    void Draw(Shader& shader);
+    // 绘制函数声明（单个实例，model 为模型矩阵）
+    void Draw(Shader& shader, const glm::mat4& model);
+
+    // 把所有网格移入共享几何池（见 GeometryArena.h）
+    void MoveToArena(GeometryArena& arena);
 
 private:
     // 声明 loadOBJ 函数（供内部调用）
     void loadOBJ(const std::string& path);
+    bool loadFromCache(const std::string& path, const MeshCacheSource& source);
+    void logMemory(const std::string& path) const;
     void calculateNormals(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+
+    ModelLoadOptions loadOptions;
 };
 
 #endif
\ No newline at end of file
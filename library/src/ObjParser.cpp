@@ -0,0 +1,972 @@
+#include "ObjParser.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// 与 isspace 相同的空白字符集合（换行由行切分处理）
+inline bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
+}
+
+inline const char* SkipToken(const char* p, const char* end) {
+    while (p < end && !IsBlank(*p)) ++p;
+    return p;
+}
+
+// float 可精确表示的 10 的幂（10^0 ~ 10^10）
+const float kPow10f[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+// 慢速路径：把记号复制到栈缓冲区后交给 strtof（与 istringstream 的取值完全一致）
+float SlowParseFloat(const char* begin, const char* end) {
+    char buf[64];
+    const size_t len = static_cast<size_t>(end - begin);
+    if (len < sizeof(buf)) {
+        std::memcpy(buf, begin, len);
+        buf[len] = '\0';
+        return std::strtof(buf, nullptr);
+    }
+    // 超长记号极为罕见，此时才使用堆内存
+    std::string token(begin, end);
+    return std::strtof(token.c_str(), nullptr);
+}
+
+// 扫描一个浮点数（语法同 operator>>(float&)：[+-]digits[.digits][(e|E)[+-]digits]）
+// 成功时推进 p 并返回 true；失败时 out = 0
+bool ScanFloat(const char*& p, const char* end, float& out) {
+    const char* s = SkipBlanks(p, end);
+    const char* q = s;
+
+    bool negative = false;
+    if (q < end && (*q == '+' || *q == '-')) {
+        negative = (*q == '-');
+        ++q;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    while (q < end && IsDigit(*q)) {
+        anyDigits = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+            if (mantissa != 0) ++significantDigits;
+        } else {
+            ++exponent;
+            ++significantDigits;
+        }
+        ++q;
+    }
+    if (q < end && *q == '.') {
+        ++q;
+        while (q < end && IsDigit(*q)) {
+            anyDigits = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+                if (mantissa != 0) ++significantDigits;
+                --exponent;
+            } else {
+                ++significantDigits;
+            }
+            ++q;
+        }
+    }
+    if (!anyDigits) {
+        out = 0.0f;
+        return false;
+    }
+
+    // 指数部分：只有后面确实跟着数字时才消费 'e'
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        const char* e = q + 1;
+        bool expNegative = false;
+        if (e < end && (*e == '+' || *e == '-')) {
+            expNegative = (*e == '-');
+            ++e;
+        }
+        if (e < end && IsDigit(*e)) {
+            int expValue = 0;
+            while (e < end && IsDigit(*e)) {
+                if (expValue < 10000) expValue = expValue * 10 + (*e - '0');
+                ++e;
+            }
+            exponent += expNegative ? -expValue : expValue;
+            q = e;
+        }
+    }
+
+    // 去掉尾随的 0，尽量落入快速路径
+    while (mantissa > (1u << 24) && mantissa % 10 == 0 && exponent < 0) {
+        mantissa /= 10;
+        ++exponent;
+    }
+
+    // 快速路径（Clinger）：尾数和 10 的幂都能被 float 精确表示时，一次乘/除即得到正确舍入的结果
+    if (significantDigits <= 19 && mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10) {
+        float value = static_cast<float>(mantissa);
+        if (exponent < 0) value /= kPow10f[-exponent];
+        else value *= kPow10f[exponent];
+        out = negative ? -value : value;
+    } else {
+        out = SlowParseFloat(s, q);
+    }
+
+    p = q;
+    return true;
+}
+
+// 索引片段的解析结果（模拟 std::stoi 的三种情况）
+enum class IndexPart {
+    Empty,    // 片段为空（例如 "v//vn" 中间的部分）
+    Invalid,  // 非数字或超出 int 范围（stoi 会抛异常）
+    Ok
+};
+
+// 解析 [begin, end) 内的整数；允许尾随非数字字符（与 stoi 一致）
+IndexPart ScanIndex(const char* begin, const char* end, int& out) {
+    if (begin == end) return IndexPart::Empty;
+
+    const char* q = begin;
+    bool negative = false;
+    if (*q == '+' || *q == '-') {
+        negative = (*q == '-');
+        ++q;
+    }
+    if (q == end || !IsDigit(*q)) return IndexPart::Invalid;
+
+    int64_t value = 0;
+    while (q < end && IsDigit(*q)) {
+        value = value * 10 + (*q - '0');
+        if (value > 2147483648LL) return IndexPart::Invalid;
+        ++q;
+    }
+    if (negative) value = -value;
+    if (value > 2147483647LL) return IndexPart::Invalid;
+
+    out = static_cast<int>(value);
+    return IndexPart::Ok;
+}
+
+// 分组切换事件（g/o 或 usemtl），face 为块内的面序号
+struct GroupEvent {
+    size_t face;
+    bool isMaterial;
+    std::string name;
+};
+
+// 单个解析块的上下文：属性直接写入共享数组中本块的区间，面索引写入块内数组
+struct ChunkContext {
+    ObjData* out;
+    const std::string* path;
+
+    // 解析到当前行时的全局计数（块起始偏移 + 块内已解析数量）
+    size_t vCount = 0;
+    size_t tCount = 0;
+    size_t nCount = 0;
+
+    std::vector<unsigned int> vIndices;
+    std::vector<unsigned int> tIndices;
+    std::vector<unsigned int> nIndices;
+    std::vector<unsigned int> faceSizes;
+    std::vector<GroupEvent> events;
+};
+
+const unsigned int kInvalidIndex = 0xFFFFFFFFu;
+
+// OBJ 索引转换为 0 起始：正数为全局 1 起始索引，负数相对于当前已定义的数量（-1 为最近一个）
+inline unsigned int ResolveIndex(int value, size_t currentCount) {
+    if (value > 0) return static_cast<unsigned int>(value - 1);
+    if (value < 0 && static_cast<size_t>(-static_cast<int64_t>(value)) <= currentCount) {
+        return static_cast<unsigned int>(currentCount - static_cast<size_t>(-static_cast<int64_t>(value)));
+    }
+    return kInvalidIndex;
+}
+
+// 解析单个面角点 "v" / "v/vt" / "v//vn" / "v/vt/vn"，角点被跳过时返回 false
+bool ParseFaceCorner(const char* begin, const char* end, ChunkContext& ctx) {
+    // 按 '/' 切分，最多 3 段（多余部分忽略）；"1/" 这种结尾的空片段等价于不存在
+    const char* partBegin[3] = { begin, end, end };
+    const char* partEnd[3] = { end, end, end };
+    int partCount = 1;
+    for (const char* q = begin; q < end; ++q) {
+        if (*q != '/') continue;
+        partEnd[partCount - 1] = q;
+        if (partCount == 3) break;
+        partBegin[partCount] = q + 1;
+        ++partCount;
+    }
+
+    unsigned int vIdx = 0;
+    unsigned int tIdx = 0;
+    unsigned int nIdx = 0;
+    bool hasTexIndex = false;
+    bool hasNormalIndex = false;
+    int value = 0;
+
+    IndexPart r = ScanIndex(partBegin[0], partEnd[0], value);
+    if (r == IndexPart::Ok) {
+        vIdx = ResolveIndex(value, ctx.vCount);
+    } else if (r == IndexPart::Invalid) {
+        std::cerr << "WARNING::MODEL::INVALID_VERTEX_FORMAT: " << std::string(partBegin[0], partEnd[0]) << " in " << *ctx.path << std::endl;
+    }
+
+    if (partCount >= 2 && ScanIndex(partBegin[1], partEnd[1], value) == IndexPart::Ok) {
+        tIdx = ResolveIndex(value, ctx.tCount);
+        hasTexIndex = true;
+    }
+    if (partCount >= 3 && ScanIndex(partBegin[2], partEnd[2], value) == IndexPart::Ok) {
+        nIdx = ResolveIndex(value, ctx.nCount);
+        hasNormalIndex = true;
+    }
+
+    // 验证顶点索引是否有效（只能引用当前行之前定义的顶点）
+    if (vIdx >= ctx.vCount) {
+        std::cerr << "WARNING::MODEL::INVALID_VERTEX_INDEX: " << vIdx << " (max: " << ctx.vCount - 1 << ") in " << *ctx.path << std::endl;
+        return false;
+    }
+    ctx.vIndices.push_back(vIdx);
+
+    if (hasTexIndex && tIdx >= ctx.tCount) {
+        std::cerr << "WARNING::MODEL::INVALID_TEXCOORD_INDEX: " << tIdx << " (max: " << ctx.tCount - 1 << ") in " << *ctx.path << std::endl;
+        hasTexIndex = false;
+    }
+    ctx.tIndices.push_back(hasTexIndex ? tIdx : 0);  // 0 为占位符
+
+    if (hasNormalIndex && nIdx >= ctx.nCount) {
+        std::cerr << "WARNING::MODEL::INVALID_NORMAL_INDEX: " << nIdx << " (max: " << ctx.nCount - 1 << ") in " << *ctx.path << std::endl;
+        hasNormalIndex = false;
+    }
+    ctx.nIndices.push_back(hasNormalIndex ? nIdx : 0);  // 0 为占位符
+    return true;
+}
+
+// 行尾注释（"f 1 2 3 # ..."）之前的部分
+inline const char* StripComment(const char* p, const char* end) {
+    const char* hash = static_cast<const char*>(std::memchr(p, '#', static_cast<size_t>(end - p)));
+    return hash != nullptr ? hash : end;
+}
+
+void ParseFace(const char* p, const char* end, ChunkContext& ctx) {
+    end = StripComment(p, end);
+
+    // 先确认至少有 3 个角点记号
+    int tokenCount = 0;
+    for (const char* q = SkipBlanks(p, end); q < end && tokenCount < 3; q = SkipBlanks(SkipToken(q, end), end)) {
+        ++tokenCount;
+    }
+    if (tokenCount < 3) {
+        std::cerr << "WARNING::MODEL::INVALID_FACE: face has less than 3 vertices in " << *ctx.path << std::endl;
+        return;
+    }
+
+    // 多边形保留全部角点，三角化在加载阶段进行
+    unsigned int cornerCount = 0;
+    for (p = SkipBlanks(p, end); p < end; p = SkipBlanks(p, end)) {
+        const char* tokenEnd = SkipToken(p, end);
+        if (ParseFaceCorner(p, tokenEnd, ctx)) ++cornerCount;
+        p = tokenEnd;
+    }
+    if (cornerCount > 0) ctx.faceSizes.push_back(cornerCount);
+}
+
+// g/o/usemtl 后面的名称（去掉首尾空白和行尾注释；g 的多个组名作为一个整体）
+void ParseGroupEvent(const char* p, const char* end, bool isMaterial, ChunkContext& ctx) {
+    end = StripComment(p, end);
+    p = SkipBlanks(p, end);
+    while (end > p && IsBlank(end[-1])) --end;
+
+    GroupEvent event;
+    event.face = ctx.faceSizes.size();
+    event.isMaterial = isMaterial;
+    event.name.assign(p, end);
+    ctx.events.push_back(std::move(event));
+}
+
+enum class LineType {
+    Other,
+    Position,  // v
+    TexCoord,  // vt
+    Normal,    // vn
+    Face,      // f
+    Group,     // g / o
+    Material   // usemtl
+};
+
+// 识别行类型，p 前进到类型记号之后
+inline LineType ClassifyLine(const char*& p, const char* end) {
+    p = SkipBlanks(p, end);
+    const char* typeEnd = SkipToken(p, end);
+    const size_t typeLen = static_cast<size_t>(typeEnd - p);
+    LineType type = LineType::Other;
+    if (typeLen == 1 && p[0] == 'v') type = LineType::Position;
+    else if (typeLen == 2 && p[0] == 'v' && p[1] == 't') type = LineType::TexCoord;
+    else if (typeLen == 2 && p[0] == 'v' && p[1] == 'n') type = LineType::Normal;
+    else if (typeLen == 1 && p[0] == 'f') type = LineType::Face;
+    else if (typeLen == 1 && (p[0] == 'g' || p[0] == 'o')) type = LineType::Group;
+    else if (typeLen == 6 && std::memcmp(p, "usemtl", 6) == 0) type = LineType::Material;
+    p = typeEnd;
+    return type;
+}
+
+inline const char* FindLineEnd(const char* p, const char* end) {
+    const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+    return lineEnd != nullptr ? lineEnd : end;
+}
+
+// 按行边界切分成 threadCount 块（每块至少 1 MB，小文件退化为单块），返回各块的起点和结尾
+std::vector<const char*> SplitChunks(const char* data, size_t size, unsigned int threadCount) {
+    const size_t kMinChunkBytes = 1u << 20;
+    const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, size / kMinChunkBytes));
+    const char* const end = data + size;
+    std::vector<const char*> bounds;
+    bounds.reserve(chunkCount + 1);
+    bounds.push_back(data);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char* target = data + size * i / chunkCount;
+        if (target <= bounds.back()) continue;
+        const char* lineEnd = FindLineEnd(target, end);
+        if (lineEnd >= end) break;
+        bounds.push_back(lineEnd + 1);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+// 第一遍：只统计块内 v/vt/vn 的数量，用于计算每块在全局数组中的起始偏移
+void CountChunk(const char* p, const char* end, size_t& vCount, size_t& tCount, size_t& nCount) {
+    while (p < end) {
+        const char* lineEnd = FindLineEnd(p, end);
+        switch (ClassifyLine(p, lineEnd)) {
+            case LineType::Position: ++vCount; break;
+            case LineType::TexCoord: ++tCount; break;
+            case LineType::Normal:   ++nCount; break;
+            default: break;
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// 第二遍：完整解析块内容
+void ParseChunk(const char* p, const char* end, ChunkContext& ctx) {
+    ObjData& out = *ctx.out;
+    while (p < end) {
+        const char* lineEnd = FindLineEnd(p, end);
+        const char* q = p;
+        switch (ClassifyLine(q, lineEnd)) {
+            case LineType::Position: {
+                glm::vec3& v = out.positions[ctx.vCount++];
+                if (ScanFloat(q, lineEnd, v.x) && ScanFloat(q, lineEnd, v.y)) ScanFloat(q, lineEnd, v.z);
+                break;
+            }
+            case LineType::TexCoord: {
+                glm::vec2& vt = out.texCoords[ctx.tCount++];
+                if (ScanFloat(q, lineEnd, vt.x)) ScanFloat(q, lineEnd, vt.y);
+                break;
+            }
+            case LineType::Normal: {
+                glm::vec3& n = out.normals[ctx.nCount++];
+                if (ScanFloat(q, lineEnd, n.x) && ScanFloat(q, lineEnd, n.y)) ScanFloat(q, lineEnd, n.z);
+                break;
+            }
+            case LineType::Face:
+                ParseFace(q, lineEnd, ctx);
+                break;
+            case LineType::Group:
+                ParseGroupEvent(q, lineEnd, false, ctx);
+                break;
+            case LineType::Material:
+                ParseGroupEvent(q, lineEnd, true, ctx);
+                break;
+            default:
+                break;
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// 按文件顺序回放所有块的切换事件，生成覆盖全部面的非空分组
+void BuildGroups(const std::vector<ChunkContext>& chunks, const std::vector<size_t>& faceOffsets, ObjData& out) {
+    const size_t faceCount = out.faceSizes.size();
+    std::string name;
+    std::string material;
+    size_t groupFace = 0;
+    size_t groupCorner = 0;
+    size_t cornerCursor = 0;
+    size_t faceCursor = 0;
+
+    auto startGroup = [&](size_t face) {
+        while (faceCursor < face) cornerCursor += out.faceSizes[faceCursor++];
+        if (face > groupFace) {
+            ObjGroup group;
+            group.name = name;
+            group.material = material;
+            group.faceBegin = groupFace;
+            group.faceEnd = face;
+            group.cornerBegin = groupCorner;
+            out.groups.push_back(std::move(group));
+        }
+        groupFace = face;
+        groupCorner = cornerCursor;
+    };
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (const GroupEvent& event : chunks[i].events) {
+            startGroup(faceOffsets[i] + event.face);
+            (event.isMaterial ? material : name) = event.name;
+        }
+    }
+    startGroup(faceCount);
+}
+
+// 二维叉积（a × b 的 z 分量）
+inline float Cross2(const glm::vec2& a, const glm::vec2& b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+// p 是否在逆时针三角形 abc 内（含边界）
+inline bool PointInTriangle(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+    return Cross2(b - a, p - a) >= 0.0f && Cross2(c - b, p - b) >= 0.0f && Cross2(a - c, p - c) >= 0.0f;
+}
+
+} // namespace
+
+void ParseOBJ(const char* data, size_t size, ObjData& out, const std::string& path, unsigned int threadCount,
+              ThreadPool* threadPool) {
+    if (data == nullptr || size == 0) return;
+
+    ThreadPool& pool = threadPool != nullptr ? *threadPool : ThreadPool::Shared();
+    if (threadCount == 0) threadCount = pool.GetConcurrency();
+
+    const std::vector<const char*> bounds = SplitChunks(data, size, threadCount);
+    const size_t chunkCount = bounds.size() - 1;
+
+    // 第一遍：统计每块的 v/vt/vn 数量
+    std::vector<ChunkContext> chunks(chunkCount);
+    pool.ParallelFor(chunkCount, [&](size_t i) {
+        CountChunk(bounds[i], bounds[i + 1], chunks[i].vCount, chunks[i].tCount, chunks[i].nCount);
+    });
+
+    // 前缀和：每块的计数改为全局起始偏移，属性数组按总数一次性分配
+    size_t vTotal = 0, tTotal = 0, nTotal = 0;
+    for (ChunkContext& ctx : chunks) {
+        const size_t v = ctx.vCount, t = ctx.tCount, n = ctx.nCount;
+        ctx.vCount = vTotal;
+        ctx.tCount = tTotal;
+        ctx.nCount = nTotal;
+        vTotal += v;
+        tTotal += t;
+        nTotal += n;
+        ctx.out = &out;
+        ctx.path = &path;
+    }
+    out.positions.assign(vTotal, glm::vec3(0.0f));
+    out.texCoords.assign(tTotal, glm::vec2(0.0f));
+    out.normals.assign(nTotal, glm::vec3(0.0f));
+
+    // 第二遍：并行解析；由于偏移已知，相对索引和越界检查与单线程结果完全一致
+    pool.ParallelFor(chunkCount, [&](size_t i) {
+        ParseChunk(bounds[i], bounds[i + 1], chunks[i]);
+    });
+
+    // 按块顺序拼接面索引和面大小
+    std::vector<size_t> cornerOffsets(chunkCount + 1, 0);
+    std::vector<size_t> faceOffsets(chunkCount + 1, 0);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        cornerOffsets[i + 1] = cornerOffsets[i] + chunks[i].vIndices.size();
+        faceOffsets[i + 1] = faceOffsets[i] + chunks[i].faceSizes.size();
+    }
+
+    if (chunkCount == 1) {
+        out.vIndices.swap(chunks[0].vIndices);
+        out.tIndices.swap(chunks[0].tIndices);
+        out.nIndices.swap(chunks[0].nIndices);
+        out.faceSizes.swap(chunks[0].faceSizes);
+    } else {
+        out.vIndices.resize(cornerOffsets[chunkCount]);
+        out.tIndices.resize(cornerOffsets[chunkCount]);
+        out.nIndices.resize(cornerOffsets[chunkCount]);
+        out.faceSizes.resize(faceOffsets[chunkCount]);
+        pool.ParallelFor(chunkCount, [&](size_t i) {
+            std::copy(chunks[i].vIndices.begin(), chunks[i].vIndices.end(), out.vIndices.begin() + cornerOffsets[i]);
+            std::copy(chunks[i].tIndices.begin(), chunks[i].tIndices.end(), out.tIndices.begin() + cornerOffsets[i]);
+            std::copy(chunks[i].nIndices.begin(), chunks[i].nIndices.end(), out.nIndices.begin() + cornerOffsets[i]);
+            std::copy(chunks[i].faceSizes.begin(), chunks[i].faceSizes.end(), out.faceSizes.begin() + faceOffsets[i]);
+        });
+    }
+
+    BuildGroups(chunks, faceOffsets, out);
+}
+
+void TriangulateFace(const ObjData& obj, size_t firstCorner, unsigned int cornerCount, std::vector<unsigned int>& outCorners) {
+    if (cornerCount < 3) return;
+
+    const unsigned int first = static_cast<unsigned int>(firstCorner);
+    if (cornerCount == 3) {
+        outCorners.push_back(first);
+        outCorners.push_back(first + 1);
+        outCorners.push_back(first + 2);
+        return;
+    }
+
+    auto position = [&](unsigned int i) -> const glm::vec3& { return obj.positions[obj.vIndices[firstCorner + i]]; };
+
+    // Newell 法线：对非平面多边形也稳定，用来选择投影平面
+    glm::vec3 normal(0.0f);
+    for (unsigned int i = 0; i < cornerCount; ++i) {
+        const glm::vec3& a = position(i);
+        const glm::vec3& b = position((i + 1) % cornerCount);
+        normal.x += (a.y - b.y) * (a.z + b.z);
+        normal.y += (a.z - b.z) * (a.x + b.x);
+        normal.z += (a.x - b.x) * (a.y + b.y);
+    }
+    const glm::vec3 absNormal = glm::abs(normal);
+    const int axis = (absNormal.x > absNormal.y && absNormal.x > absNormal.z) ? 0 : (absNormal.y > absNormal.z ? 1 : 2);
+    // 投影到与主轴垂直的平面，并保证投影后为逆时针
+    int uAxis = (axis + 1) % 3;
+    int vAxis = (axis + 2) % 3;
+    if (normal[axis] < 0.0f) std::swap(uAxis, vAxis);
+
+    // 常见的小多边形使用栈上缓冲
+    const unsigned int kStackCorners = 32;
+    glm::vec2 stackPoints[kStackCorners];
+    unsigned int stackRemaining[kStackCorners];
+    std::vector<glm::vec2> heapPoints;
+    std::vector<unsigned int> heapRemaining;
+    glm::vec2* points = stackPoints;
+    unsigned int* remaining = stackRemaining;
+    if (cornerCount > kStackCorners) {
+        heapPoints.resize(cornerCount);
+        heapRemaining.resize(cornerCount);
+        points = heapPoints.data();
+        remaining = heapRemaining.data();
+    }
+    for (unsigned int i = 0; i < cornerCount; ++i) {
+        const glm::vec3& p = position(i);
+        points[i] = glm::vec2(p[uAxis], p[vAxis]);
+        remaining[i] = i;
+    }
+
+    auto emit = [&](unsigned int a, unsigned int b, unsigned int c) {
+        outCorners.push_back(first + a);
+        outCorners.push_back(first + b);
+        outCorners.push_back(first + c);
+    };
+
+    // 耳切：凸顶点且三角形内不含其他剩余顶点时切下
+    unsigned int count = cornerCount;
+    unsigned int k = 0;
+    unsigned int attempts = 0;
+    while (count > 3) {
+        if (attempts == count) {
+            // 一整圈都没有找到耳朵（退化/自相交），剩余部分按扇形处理
+            for (unsigned int i = 1; i + 1 < count; ++i) emit(remaining[0], remaining[i], remaining[i + 1]);
+            return;
+        }
+
+        const unsigned int prev = remaining[(k + count - 1) % count];
+        const unsigned int cur = remaining[k];
+        const unsigned int next = remaining[(k + 1) % count];
+        const glm::vec2& a = points[prev];
+        const glm::vec2& b = points[cur];
+        const glm::vec2& c = points[next];
+
+        bool isEar = Cross2(b - a, c - b) > 0.0f;
+        for (unsigned int i = 0; isEar && i < count; ++i) {
+            const unsigned int other = remaining[i];
+            if (other == prev || other == cur || other == next) continue;
+            const glm::vec2& p = points[other];
+            if (p == a || p == b || p == c) continue;  // 重合顶点不阻挡
+            if (PointInTriangle(p, a, b, c)) isEar = false;
+        }
+
+        if (isEar) {
+            emit(prev, cur, next);
+            std::copy(remaining + k + 1, remaining + count, remaining + k);
+            --count;
+            if (k >= count) k = 0;
+            attempts = 0;
+        } else {
+            k = (k + 1) % count;
+            ++attempts;
+        }
+    }
+    emit(remaining[0], remaining[1], remaining[2]);
+}
+
+void ParseOBJReference(const char* data, size_t size, ObjData& out, const std::string& path) {
+    std::vector<glm::vec3> temp_vertices;  // 临时顶点位置
+    std::vector<glm::vec2> temp_texCoords; // 临时纹理坐标
+    std::vector<glm::vec3> temp_normals;   // 临时法线
+    std::vector<unsigned int> vIndices, tIndices, nIndices;  // 顶点/纹理/法线索引
+
+    // 以下循环原样取自 Model::loadOBJ 的旧版本，只有输入流由 std::ifstream file(path) 换成内存中的文本
+    std::istringstream file(std::string(data, size));
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string type;
+        iss >> type;
+
+        // 1. 解析顶点位置（v x y z）
+        if (type == "v") {
+            glm::vec3 v;
+            iss >> v.x >> v.y >> v.z;
+            temp_vertices.push_back(v);
+        }
+        // 2. 解析纹理坐标（vt u v）
+        else if (type == "vt") {
+            glm::vec2 vt;
+            iss >> vt.x >> vt.y;
+            temp_texCoords.push_back(vt);
+        }
+        // 3. 解析法线（vn x y z）
+        else if (type == "vn") {
+            glm::vec3 n;
+            iss >> n.x >> n.y >> n.z;
+            temp_normals.push_back(n);
+        }
+        // 4. 解析面（支持多种格式：f v1 v2 v3 或 f v1/vt1 v2/vt2 v3/vt3 或 f v1//vn1 或 f v1/vt1/vn1）
+        else if (type == "f") {
+            std::string vertexStr;
+            std::vector<std::string> faceVertices;
+            
+            // 读取面的所有顶点（不假设只有3个，但只处理前3个）
+            while (iss >> vertexStr) {
+                faceVertices.push_back(vertexStr);
+            }
+            
+            // 只处理三角形面（至少3个顶点）
+            if (faceVertices.size() < 3) {
+                std::cerr << "WARNING::MODEL::INVALID_FACE: face has less than 3 vertices in " << path << std::endl;
+                continue;
+            }
+            
+            // 处理前3个顶点（如果是多边形，只取前3个构成三角形）
+            for (int i = 0; i < 3; i++) {
+                std::istringstream vss(faceVertices[i]);
+                std::string part;
+                unsigned int vIdx = 0;
+                bool hasTexIndex = false;
+                unsigned int tIdx = 0;
+                bool hasNormalIndex = false;
+                unsigned int nIdx = 0;
+
+                // 分割逻辑：处理多种格式
+                // "v" 或 "v/vt" 或 "v//vn" 或 "v/vt/vn"
+                int partCount = 0;
+                while (std::getline(vss, part, '/')) {
+                    partCount++;
+                    if (partCount == 1 && !part.empty()) {  // 第一个部分：顶点索引
+                        try {
+                            vIdx = std::stoi(part) - 1;  // OBJ索引1→0
+                        } catch (const std::exception& e) {
+                            std::cerr << "WARNING::MODEL::INVALID_VERTEX_FORMAT: " << part << " in " << path << std::endl;
+                            vIdx = 0;
+                        }
+                    }
+                    else if (partCount == 2 && !part.empty()) {  // 第二个部分：纹理坐标索引
+                        try {
+                            tIdx = std::stoi(part) - 1;
+                            hasTexIndex = true;
+                        } catch (const std::exception& e) {
+                            // 无法解析纹理坐标索引，忽略
+                        }
+                    }
+                    else if (partCount == 3 && !part.empty()) {  // 第三个部分：法线索引
+                        try {
+                            nIdx = std::stoi(part) - 1;
+                            hasNormalIndex = true;
+                        } catch (const std::exception& e) {
+                            // 无法解析法线索引，忽略
+                        }
+                    }
+                }
+
+                // 验证顶点索引是否有效
+                if (vIdx >= temp_vertices.size()) {
+                    std::cerr << "WARNING::MODEL::INVALID_VERTEX_INDEX: " << vIdx << " (max: " << temp_vertices.size() - 1 << ") in " << path << std::endl;
+                    continue;
+                }
+                
+                vIndices.push_back(vIdx);
+                
+                // 如果有纹理坐标索引，验证并保存
+                if (hasTexIndex) {
+                    if (tIdx >= temp_texCoords.size()) {
+                        std::cerr << "WARNING::MODEL::INVALID_TEXCOORD_INDEX: " << tIdx << " (max: " << temp_texCoords.size() - 1 << ") in " << path << std::endl;
+                        tIndices.push_back(0);  // 占位符
+                    } else {
+                        tIndices.push_back(tIdx);
+                    }
+                } else {
+                    // 没有纹理坐标索引，添加占位符
+                    tIndices.push_back(0);  // 占位符，后续会用默认值或生成
+                }
+                
+                // 如果有法线索引，验证并保存
+                if (hasNormalIndex) {
+                    if (nIdx >= temp_normals.size()) {
+                        std::cerr << "WARNING::MODEL::INVALID_NORMAL_INDEX: " << nIdx << " (max: " << temp_normals.size() - 1 << ") in " << path << std::endl;
+                        nIndices.push_back(0);  // 占位符
+                    } else {
+                        nIndices.push_back(nIdx);
+                    }
+                } else {
+                    // 没有法线索引，添加占位符
+                    nIndices.push_back(0);  // 占位符
+                }
+            }
+        }
+    }
+
+    out.positions.swap(temp_vertices);
+    out.texCoords.swap(temp_texCoords);
+    out.normals.swap(temp_normals);
+    out.vIndices.swap(vIndices);
+    out.tIndices.swap(tIndices);
+    out.nIndices.swap(nIndices);
+}
+
+namespace {
+
+// 基准测试用的合成 OBJ：每块 64 个面，先写本块的 v/vt/vn，再写引用它们的面
+// 面的写法轮流使用绝对索引 v/vt/vn、负的相对索引、v//vn 和四边形；坐标混用普通小数和指数形式，
+// 每 16 块切换组名、每 64 块切换材质，并带有行尾注释
+// 每块第一个相对索引的面还引用上一块的最后一个顶点：无论切块边界落在哪一行，
+// 边界之后的两块之内都有负相对索引引用边界之前的顶点
+// baselineCompatible 为 true 时只写旧版 loadOBJ 能正确解析的内容：三角形、正的绝对索引，
+// 面的写法轮流为 v/vt/vn、v/vt、v//vn 和 v
+std::string GenerateBenchmarkObj(size_t faceCount, bool baselineCompatible) {
+    const size_t kBlockFaces = 64;
+    const size_t kBlockVertices = kBlockFaces + 3;
+    std::string text;
+    text.reserve(faceCount * 96);
+    text += "# synthetic OBJ for --bench-obj\n";
+
+    char buf[160];
+    auto append = [&](int length) { text.append(buf, static_cast<size_t>(length)); };
+
+    long long vCount = 0;
+    long long nCount = 0;
+    size_t faces = 0;
+    for (size_t block = 0; faces < faceCount; ++block) {
+        if (block % 16 == 0) append(std::snprintf(buf, sizeof(buf), "g part_%zu\n", block / 16));
+        if (block % 64 == 0) append(std::snprintf(buf, sizeof(buf), "usemtl material_%zu # switch\n", block / 64 % 7));
+
+        const long long base = vCount + 1;  // 本块第一个顶点的 1 起始索引
+        for (size_t i = 0; i < kBlockVertices; ++i) {
+            const float x = static_cast<float>(block) * 0.5f + static_cast<float>(i / 2) * 0.125f;
+            const float y = static_cast<float>(i % 2) - 0.375f;
+            const float z = static_cast<float>((block * 131 + i * 37) % 1009) * 1e-6f;
+            append(std::snprintf(buf, sizeof(buf), "v %.6g %.6g %.6g\n", x, y, z));
+        }
+        for (size_t i = 0; i < kBlockVertices; ++i) {
+            append(std::snprintf(buf, sizeof(buf), "vt %.6g %.6g\n", static_cast<float>(i) / kBlockVertices,
+                                 static_cast<float>(block % 2)));
+        }
+        append(std::snprintf(buf, sizeof(buf), "vn 0 %.6g 1\n", static_cast<float>(block % 3) * 0.25f));
+        vCount += kBlockVertices;
+        ++nCount;
+
+        for (size_t j = 0; j < kBlockFaces && faces < faceCount; ++j, ++faces) {
+            const long long a = base + static_cast<long long>(j);
+            const long long b = a + 1, c = a + 2, d = a + 3;
+            const long long ra = a - vCount - 1, rb = b - vCount - 1;  // 负的相对索引
+            const long long rc = (j == 1 && block > 0 ? base - 1 : c) - vCount - 1;
+            if (baselineCompatible) {
+                switch (j % 4) {
+                    case 0:
+                        append(std::snprintf(buf, sizeof(buf), "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+                                             a, a, nCount, b, b, nCount, c, c, nCount));
+                        break;
+                    case 1:
+                        append(std::snprintf(buf, sizeof(buf), "f %lld/%lld %lld/%lld %lld/%lld\n", a, a, b, b, c, c));
+                        break;
+                    case 2:
+                        append(std::snprintf(buf, sizeof(buf), "f %lld//%lld %lld//%lld %lld//%lld\n", a, nCount, b, nCount, c, nCount));
+                        break;
+                    default:
+                        append(std::snprintf(buf, sizeof(buf), "f %lld %lld %lld\n", a, b, c));
+                        break;
+                }
+                continue;
+            }
+            switch (j % 4) {
+                case 0:
+                    append(std::snprintf(buf, sizeof(buf), "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+                                         a, a, nCount, b, b, nCount, c, c, nCount));
+                    break;
+                case 1:
+                    append(std::snprintf(buf, sizeof(buf), "f %lld/%lld/-1 %lld/%lld/-1 %lld/%lld/-1\n",
+                                         ra, ra, rb, rb, rc, rc));
+                    break;
+                case 2:
+                    append(std::snprintf(buf, sizeof(buf), "f %lld//%lld %lld//%lld %lld//%lld\n", a, nCount, b, nCount, c, nCount));
+                    break;
+                default:
+                    append(std::snprintf(buf, sizeof(buf), "f %lld %lld %lld %lld # quad\n", a, b, d, c));
+                    break;
+            }
+        }
+    }
+    return text;
+}
+
+// 逐字段比较两份解析结果，不一致时返回第一个不同的字段名
+// 旧版 loadOBJ 不记录面大小和分组，与它比较时 verticesOnly 为 true，只比较顶点数组和三组角点索引
+const char* FindObjDataMismatch(const ObjData& a, const ObjData& b, bool verticesOnly = false) {
+    if (a.positions != b.positions) return "positions";
+    if (a.texCoords != b.texCoords) return "texCoords";
+    if (a.normals != b.normals) return "normals";
+    if (a.vIndices != b.vIndices) return "vIndices";
+    if (a.tIndices != b.tIndices) return "tIndices";
+    if (a.nIndices != b.nIndices) return "nIndices";
+    if (verticesOnly) return nullptr;
+    if (a.faceSizes != b.faceSizes) return "faceSizes";
+    if (a.groups.size() != b.groups.size()) return "groups";
+    for (size_t i = 0; i < a.groups.size(); ++i) {
+        const ObjGroup& x = a.groups[i];
+        const ObjGroup& y = b.groups[i];
+        if (x.name != y.name || x.material != y.material || x.faceBegin != y.faceBegin ||
+            x.faceEnd != y.faceEnd || x.cornerBegin != y.cornerBegin) {
+            return "groups";
+        }
+    }
+    return nullptr;
+}
+
+// 按 ParseOBJ 的规则切成 threadCount 块，统计有多少个块边界之后的面用负相对索引引用了边界之前的顶点
+// （只查看边界之后 512 行，合成文件保证两块之内一定出现）
+size_t CountCrossChunkReferences(const std::string& text, unsigned int threadCount) {
+    const char* const end = text.data() + text.size();
+    const std::vector<const char*> bounds = SplitChunks(text.data(), text.size(), threadCount);
+    size_t crossing = 0;
+    size_t vBefore = 0;
+    const char* p = text.data();
+    for (size_t i = 1; i + 1 < bounds.size(); ++i) {
+        for (; p < bounds[i]; ) {
+            const char* lineEnd = FindLineEnd(p, end);
+            const char* q = p;
+            if (ClassifyLine(q, lineEnd) == LineType::Position) ++vBefore;
+            p = lineEnd + 1;
+        }
+
+        size_t vCount = vBefore;
+        bool found = false;
+        const char* q = bounds[i];
+        for (int line = 0; line < 512 && q < end && !found; ++line) {
+            const char* lineEnd = FindLineEnd(q, end);
+            const LineType type = ClassifyLine(q, lineEnd);
+            if (type == LineType::Position) {
+                ++vCount;
+            } else if (type == LineType::Face) {
+                for (q = SkipBlanks(q, lineEnd); q < lineEnd; q = SkipBlanks(q, lineEnd)) {
+                    const char* tokenEnd = SkipToken(q, lineEnd);
+                    int value = 0;
+                    if (*q == '-' && ScanIndex(q, tokenEnd, value) == IndexPart::Ok &&
+                        static_cast<long long>(vCount) + value < static_cast<long long>(vBefore)) {
+                        found = true;
+                    }
+                    q = tokenEnd;
+                }
+            }
+            q = lineEnd + 1;
+        }
+        if (found) ++crossing;
+    }
+    return crossing;
+}
+
+} // namespace
+
+bool RunObjParserBenchmark(size_t faceCount) {
+    const std::string path = "<bench-obj>";
+    using Clock = std::chrono::high_resolution_clock;
+    bool match = true;
+
+    // 1. 旧版 loadOBJ 能处理的文件：两者的顶点数组和三组角点索引须完全相同
+    {
+        const std::string text = GenerateBenchmarkObj(faceCount, true);
+        const double megabytes = text.size() / (1024.0 * 1024.0);
+
+        auto start = Clock::now();
+        ObjData reference;
+        ParseOBJReference(text.data(), text.size(), reference, path);
+        const double referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        ObjData parsed;
+        ParseOBJ(text.data(), text.size(), parsed, path, 1);
+        const double parseMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const char* mismatch = FindObjDataMismatch(reference, parsed, true);
+        match = mismatch == nullptr && parsed.faceSizes.size() == faceCount &&
+                parsed.vIndices.size() == faceCount * 3;
+
+        std::cout << "OBJ::BENCHMARK: baseline-compatible file | faces " << parsed.faceSizes.size() << " | corners "
+                  << reference.vIndices.size() << " | " << megabytes << " MB" << std::endl;
+        std::cout << "OBJ::BENCHMARK: original istringstream loop " << referenceMs << " ms ("
+                  << megabytes * 1000.0 / referenceMs << " MB/s) | ParseOBJ " << parseMs << " ms ("
+                  << megabytes * 1000.0 / parseMs << " MB/s) | speedup " << referenceMs / parseMs << "x"
+                  << (match ? "" : " | RESULT MISMATCH: ") << (mismatch != nullptr ? mismatch : "") << std::endl;
+    }
+
+    // 2. 完整语法的文件（负相对索引、多边形、分组）：单线程结果作为并行解析的基准
+    const std::string text = GenerateBenchmarkObj(faceCount, false);
+    const double megabytes = text.size() / (1024.0 * 1024.0);
+    auto start = Clock::now();
+    ObjData serial;
+    ParseOBJ(text.data(), text.size(), serial, path, 1);
+    const double parseMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    match = match && serial.faceSizes.size() == faceCount;
+    std::cout << "OBJ::BENCHMARK: full-syntax file | faces " << serial.faceSizes.size() << " | corners "
+              << serial.vIndices.size() << " | groups " << serial.groups.size() << " | " << megabytes
+              << " MB | serial ParseOBJ " << parseMs << " ms (" << megabytes * 1000.0 / parseMs << " MB/s)" << std::endl;
+
+    // 并行解析：每种线程数用独立的线程池（threads 个工作线程），按同样的数量切块，结果都与单线程解析逐字段比较
+    const unsigned int kThreadCounts[] = { 1, 2, 4, 8 };
+    for (unsigned int threads : kThreadCounts) {
+        ThreadPool pool(threads);
+        const size_t chunkCount = SplitChunks(text.data(), text.size(), threads).size() - 1;
+        const size_t crossing = CountCrossChunkReferences(text, threads);
+
+        start = Clock::now();
+        ObjData parallel;
+        ParseOBJ(text.data(), text.size(), parallel, path, threads, &pool);
+        const double parallelMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const char* parallelMismatch = FindObjDataMismatch(serial, parallel);
+        const bool parallelMatch = parallelMismatch == nullptr && crossing + 1 == chunkCount;
+        match = match && parallelMatch;
+
+        std::cout << "OBJ::BENCHMARK: pool threads " << threads << " | chunks " << chunkCount
+                  << " (boundaries with cross-chunk relative indices " << crossing << ") | " << parallelMs << " ms ("
+                  << megabytes * 1000.0 / parallelMs << " MB/s) | speedup vs serial " << parseMs / parallelMs << "x";
+        if (parallelMismatch != nullptr) std::cout << " | RESULT MISMATCH: " << parallelMismatch;
+        else if (!parallelMatch) std::cout << " | MISSING CROSS-CHUNK RELATIVE INDICES";
+        std::cout << std::endl;
+    }
+    return match;
+}
@@ -0,0 +1,63 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class ThreadPool;
+
+// 连续的一段面，组名（g/o）和材质（usemtl）都相同
+struct ObjGroup {
+    std::string name;
+    std::string material;
+    size_t faceBegin = 0;    // faceSizes 中的范围 [faceBegin, faceEnd)
+    size_t faceEnd = 0;
+    size_t cornerBegin = 0;  // 第一个面的首个角点在索引数组中的位置
+};
+
+// OBJ 解析结果（与 Model::loadOBJ 原先的临时数组一一对应）
+// 索引均已转换为 0 起始；每个面角点在三个索引数组中各占一项
+struct ObjData {
+    std::vector<glm::vec3> positions;   // v
+    std::vector<glm::vec2> texCoords;   // vt
+    std::vector<glm::vec3> normals;     // vn
+    std::vector<unsigned int> vIndices; // 顶点位置索引
+    std::vector<unsigned int> tIndices; // 纹理坐标索引（缺失时为占位符 0）
+    std::vector<unsigned int> nIndices; // 法线索引（缺失时为占位符 0）
+    std::vector<unsigned int> faceSizes; // 每个面的有效角点数（按顺序排列，可能大于 3）
+    std::vector<ObjGroup> groups;        // 非空的面分组，按文件顺序覆盖全部面
+};
+
+// 直接在内存缓冲区上解析 OBJ 文本（无需以 '\0' 结尾，通常来自 MappedFile）
+//  - 逐行原地分词，手写浮点/整数扫描，不为每行创建 std::string 或 istringstream
+//  - 保留面的全部角点（多边形由 TriangulateFace 三角化），非法顶点索引的角点被跳过；
+//    负索引按 OBJ 规范相对于当前已定义的数量
+//  - g/o 和 usemtl 切换时开始新的 ObjGroup
+//  - threadCount > 1 时按行边界切块，先并行统计 v/vt/vn 数量求出每块的全局偏移，
+//    再在线程池上并行解析；结果与单线程解析逐位相同（0 表示使用线程池的全部线程）
+//  - pool 为空时使用共享线程池（基准测试传入指定线程数的线程池）
+//  - path 仅用于输出警告信息
+void ParseOBJ(const char* data, size_t size, ObjData& out, const std::string& path, unsigned int threadCount = 1,
+              ThreadPool* pool = nullptr);
+
+// 把一个面（从 firstCorner 开始的 cornerCount 个角点）三角化，
+// 结果以角点下标的形式追加到 outCorners（每 3 个一组，保持原有环绕方向）
+//  - 三角形直接输出；四边形及以上在投影平面上做耳切，可正确处理凹多边形
+//  - 退化或自相交导致找不到耳朵时，剩余部分退化为扇形三角化
+void TriangulateFace(const ObjData& obj, size_t firstCorner, unsigned int cornerCount, std::vector<unsigned int>& outCorners);
+
+// 保留的参考实现：Model::loadOBJ 改用 ParseOBJ 之前的逐行 istringstream 解析循环（原样保留）
+// 只填写 positions/texCoords/normals 和三组角点索引；每个面只取前 3 个角点，不支持负索引和分组
+// 只用于基准测试中校验 ParseOBJ 的输出和对比耗时，加载模型不使用
+void ParseOBJReference(const char* data, size_t size, ObjData& out, const std::string& path);
+
+// 无窗口基准测试（main 中通过 --bench-obj 调用），生成两份 faceCount 个面的合成 OBJ：
+//  - 旧版 loadOBJ 能处理的三角形文件：比较参考实现与单线程 ParseOBJ 的吞吐量，顶点和索引须完全相同
+//  - 含负相对索引、多边形和分组的文件：1/2/4/8 线程并行解析的结果须与单线程逐字段相同，
+//    且每个切块边界之后都有引用上一块顶点的负相对索引
+// 任一项不满足时返回 false
+bool RunObjParserBenchmark(size_t faceCount);
+
+#endif // OBJ_PARSER_H
@@ -0,0 +1,185 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cstring>
+
+OcclusionCuller::~OcclusionCuller() {
+    Cleanup();
+}
+
+void OcclusionCuller::Initialize(int depthWidth, int depthHeight) {
+    Cleanup();
+    width = depthWidth;
+    height = depthHeight;
+
+    depthShader = new Shader("shaders/depth.vert", "shaders/depth.frag");
+
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenFramebuffers(1, &depthFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenBuffers(1, &readbackPBO);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackPBO);
+    glBufferData(GL_PIXEL_PACK_BUFFER, width * height * sizeof(float), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // 各层尺寸：宽高减半（向上取整）直到 1x1
+    levelSizes.clear();
+    glm::ivec2 size(width, height);
+    levelSizes.push_back(size);
+    while (size.x > 1 || size.y > 1) {
+        size = glm::max((size + 1) / 2, glm::ivec2(1));
+        levelSizes.push_back(size);
+    }
+    levels.assign(levelSizes.size(), std::vector<float>());
+    for (size_t i = 0; i < levels.size(); ++i) {
+        levels[i].assign(static_cast<size_t>(levelSizes[i].x) * levelSizes[i].y, 1.0f);
+    }
+}
+
+void OcclusionCuller::Cleanup() {
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (depthFBO != 0) {
+        glDeleteFramebuffers(1, &depthFBO);
+        depthFBO = 0;
+    }
+    if (depthTexture != 0) {
+        glDeleteTextures(1, &depthTexture);
+        depthTexture = 0;
+    }
+    if (readbackPBO != 0) {
+        glDeleteBuffers(1, &readbackPBO);
+        readbackPBO = 0;
+    }
+    if (depthShader != nullptr) {
+        glDeleteProgram(depthShader->ID);  // Shader 没有析构函数，程序对象在这里删除
+        delete depthShader;
+        depthShader = nullptr;
+    }
+    levels.clear();
+    levelSizes.clear();
+    hasDepth = false;
+}
+
+void OcclusionCuller::Update() {
+    if (fence == nullptr) return;
+
+    // 超时为 0：只查询状态，不等待
+    const GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return;
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    const size_t bytes = levels[0].size() * sizeof(float);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackPBO);
+    const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if (data != nullptr) {
+        std::memcpy(levels[0].data(), data, bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        viewProjection = pendingViewProjection;
+        buildPyramid();
+        hasDepth = true;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void OcclusionCuller::buildPyramid() {
+    for (size_t level = 1; level < levels.size(); ++level) {
+        const std::vector<float>& src = levels[level - 1];
+        const glm::ivec2 srcSize = levelSizes[level - 1];
+        const glm::ivec2 dstSize = levelSizes[level];
+        std::vector<float>& dst = levels[level];
+        for (int y = 0; y < dstSize.y; ++y) {
+            // 奇数尺寸时最后一个 texel 覆盖 1 行/列（取值时钳制到边界，结果仍然保守）
+            const int sy0 = std::min(y * 2, srcSize.y - 1);
+            const int sy1 = std::min(y * 2 + 1, srcSize.y - 1);
+            for (int x = 0; x < dstSize.x; ++x) {
+                const int sx0 = std::min(x * 2, srcSize.x - 1);
+                const int sx1 = std::min(x * 2 + 1, srcSize.x - 1);
+                const float a = std::max(src[sy0 * srcSize.x + sx0], src[sy0 * srcSize.x + sx1]);
+                const float b = std::max(src[sy1 * srcSize.x + sx0], src[sy1 * srcSize.x + sx1]);
+                dst[y * dstSize.x + x] = std::max(a, b);
+            }
+        }
+    }
+}
+
+float OcclusionCuller::maxDepth(int level, int x0, int y0, int x1, int y1) const {
+    const std::vector<float>& data = levels[level];
+    const int rowWidth = levelSizes[level].x;
+    float result = 0.0f;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            result = std::max(result, data[y * rowWidth + x]);
+        }
+    }
+    return result;
+}
+
+bool OcclusionCuller::IsVisible(const Aabb& box) const {
+    if (!hasDepth) return true;
+
+    glm::vec3 ndcMin(1.0f);
+    glm::vec3 ndcMax(-1.0f);
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec3 point((corner & 1) ? box.max.x : box.min.x,
+                              (corner & 2) ? box.max.y : box.min.y,
+                              (corner & 4) ? box.max.z : box.min.z);
+        const glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+        // 跨过近平面的包围盒无法可靠投影，视为可见
+        if (clip.w <= 1.0e-4f) return true;
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+    // 在那一帧的屏幕之外：金字塔没有信息（可能是相机转过来的新区域），视为可见
+    if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f) return true;
+
+    const int x0 = std::max(0, static_cast<int>((ndcMin.x * 0.5f + 0.5f) * width));
+    const int y0 = std::max(0, static_cast<int>((ndcMin.y * 0.5f + 0.5f) * height));
+    const int x1 = std::min(width - 1, static_cast<int>((ndcMax.x * 0.5f + 0.5f) * width));
+    const int y1 = std::min(height - 1, static_cast<int>((ndcMax.y * 0.5f + 0.5f) * height));
+
+    // 最多 2x2 个 texel 覆盖整个矩形的层级
+    int level = 0;
+    while (level + 1 < static_cast<int>(levels.size()) &&
+           ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        ++level;
+    }
+
+    const float boxDepth = ndcMin.z * 0.5f + 0.5f;
+    return boxDepth <= maxDepth(level, x0 >> level, y0 >> level, x1 >> level, y1 >> level);
+}
+
+void OcclusionCuller::BeginOccluderPass(const glm::mat4& currentViewProjection) {
+    pendingViewProjection = currentViewProjection;
+    glGetIntegerv(GL_VIEWPORT, savedViewport);
+    glViewport(0, 0, width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void OcclusionCuller::EndOccluderPass() {
+    // 读到 PBO 中，glReadPixels 不等待 GPU 完成
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackPBO);
+    glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+}
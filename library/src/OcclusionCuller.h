@@ -0,0 +1,74 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+#include "EntityStore.h"
+#include "Shader.h"
+
+// 基于 CPU 端分层深度（Hi-Z）的遮挡剔除
+//  1. 每帧主 pass 之后，把遮挡物（墙、书架）以相机视角渲染到低分辨率深度缓冲，
+//     用 PBO 异步回读（glReadPixels 立即返回），并插入 fence
+//  2. 下一帧开始时 fence 已完成则映射 PBO，在 CPU 上按 2x2 取最大值建立深度金字塔；
+//     未完成则沿用旧金字塔，不等待 GPU
+//  3. 包围盒投影到屏幕，选取使其覆盖不超过 2x2 个texel 的层级，
+//     包围盒最近深度大于这些 texel 的最远深度时判为被遮挡
+// 金字塔来自上一帧，测试使用产生它的那一帧的视图投影矩阵；
+// 相机移动时刚露出的物体最多晚一帧出现
+class OcclusionCuller {
+public:
+    OcclusionCuller() = default;
+    ~OcclusionCuller();
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    // 创建低分辨率深度缓冲、回读 PBO 和深度着色器
+    void Initialize(int width = 256, int height = 128);
+    void Cleanup();
+
+    // 收取已完成的回读并重建金字塔（每帧在剔除之前调用一次）
+    void Update();
+
+    // 是否有可用的金字塔（首帧和禁用后为 false，此时所有物体都视为可见）
+    bool HasDepth() const { return hasDepth; }
+    void Invalidate() { hasDepth = false; }
+
+    // 包围盒是否可能可见
+    bool IsVisible(const Aabb& box) const;
+
+    // 上一次回读尚未收取时不能开始新的遮挡物 pass
+    bool CanCaptureOccluders() const { return depthFBO != 0 && fence == nullptr; }
+
+    // 遮挡物 pass：Begin 绑定低分辨率深度缓冲并清空，调用者用 GetDepthShader 提交遮挡物后调用 End
+    void BeginOccluderPass(const glm::mat4& viewProjection);
+    void EndOccluderPass();
+
+    Shader* GetDepthShader() const { return depthShader; }
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+private:
+    void buildPyramid();
+    float maxDepth(int level, int x0, int y0, int x1, int y1) const;
+
+    int width = 0;
+    int height = 0;
+    GLuint depthFBO = 0;
+    GLuint depthTexture = 0;
+    GLuint readbackPBO = 0;
+    GLsync fence = nullptr;
+    Shader* depthShader = nullptr;
+
+    GLint savedViewport[4] = { 0, 0, 0, 0 };
+    glm::mat4 pendingViewProjection = glm::mat4(1.0f);  // 正在回读的那一帧
+    glm::mat4 viewProjection = glm::mat4(1.0f);         // 当前金字塔对应的那一帧
+
+    // 金字塔：levels[0] 为回读的深度（窗口深度 [0,1]，行从下到上），之后每层宽高减半（向上取整）
+    std::vector<std::vector<float>> levels;
+    std::vector<glm::ivec2> levelSizes;
+    bool hasDepth = false;
+};
+
+#endif // OCCLUSION_CULLER_H
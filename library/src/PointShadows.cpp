@@ -0,0 +1,203 @@
+#include "PointShadows.h"
+
+#include <algorithm>
+#include <chrono>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+const UniformHandle kFaceIndexUniform("faceIndex");
+
+// 各面的近平面（灯位于灯罩内，近平面以内的几何体不投射阴影）
+const float kPointShadowNear = 0.05f;
+
+// 立方体贴图的面顺序 +X -X +Y -Y +Z -Z，与 pbr.frag 中按主轴选面的顺序一致
+const glm::vec3 kFaceDirections[6] = {
+    glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+    glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+    glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+};
+const glm::vec3 kFaceUps[6] = {
+    glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+    glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+    glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+};
+
+} // namespace
+
+PointShadowAtlas::~PointShadowAtlas() {
+    Cleanup();
+}
+
+void PointShadowAtlas::Initialize(unsigned int size) {
+    Cleanup();
+    faceSize = size;
+
+    // 深度比较 + 线性过滤，与方向光的级联阴影一样每次采样即 2x2 双线性 PCF
+    // tile 之间没有边框，着色器把采样点限制在 tile 内半个 texel 以外
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, faceSize * 6, faceSize * kMaxPointShadows, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &atlasFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlasTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    shader = new Shader("shaders/point_shadow.vert", "shaders/shadow.frag");
+    pointShadowUniforms.Initialize(kPointShadowBlockBinding, sizeof(PointShadowBlock));
+
+    for (int i = 0; i < kMaxPointShadows; ++i) slots[i] = Slot();
+    for (int i = 0; i < kMaxPointShadows * 6; ++i) faceMatrices[i] = glm::mat4(1.0f);
+}
+
+void PointShadowAtlas::Cleanup() {
+    if (atlasFBO != 0) {
+        glDeleteFramebuffers(1, &atlasFBO);
+        atlasFBO = 0;
+    }
+    if (atlasTexture != 0) {
+        glDeleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+    }
+    if (shader != nullptr) {
+        glDeleteProgram(shader->ID);  // Shader 没有析构函数，程序对象在这里删除
+        delete shader;
+        shader = nullptr;
+    }
+    pointShadowUniforms.Cleanup();
+}
+
+void PointShadowAtlas::Invalidate() {
+    for (Slot& slot : slots) slot.valid = false;
+}
+
+void PointShadowAtlas::updateFaceMatrices(int slot, const glm::vec3& position, float radius) {
+    const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, kPointShadowNear,
+                                                  std::max(radius, kPointShadowNear * 2.0f));
+    for (int face = 0; face < 6; ++face) {
+        faceMatrices[slot * 6 + face] = projection * glm::lookAt(position, position + kFaceDirections[face], kFaceUps[face]);
+    }
+}
+
+void PointShadowAtlas::Update(const std::vector<PointLight>& lights, const Frustum& cameraFrustum,
+                              const glm::vec3& cameraPosition, uint64_t sceneRevision) {
+    using Clock = std::chrono::high_resolution_clock;
+    const auto start = Clock::now();
+
+    // 1. 屏幕贡献：影响范围与视锥体不相交的灯为 0；否则为 (半径 / 距离)²，相机在影响范围内时取 1
+    const int lightCount = static_cast<int>(lights.size());
+    importance.assign(lights.size(), 0.0f);
+    ranked.clear();
+    for (int i = 0; i < lightCount; ++i) {
+        const float radius = ComputeLightRadius(lights[i]);
+        if (radius <= 0.0f) continue;
+        Aabb bounds;
+        bounds.min = lights[i].position - glm::vec3(radius);
+        bounds.max = lights[i].position + glm::vec3(radius);
+        if (!IsAabbVisible(cameraFrustum, bounds)) continue;
+        const glm::vec3 offset = lights[i].position - cameraPosition;
+        importance[i] = radius * radius / std::max(glm::dot(offset, offset), radius * radius);
+        ranked.push_back(i);
+    }
+    stats.candidates = static_cast<unsigned int>(ranked.size());
+
+    // 2. 前 kMaxPointShadows 盏占有槽位（重要性相同时按下标，排序结果逐帧稳定）
+    const size_t residentCount = std::min(ranked.size(), static_cast<size_t>(kMaxPointShadows));
+    auto moreImportant = [this](int a, int b) {
+        return importance[a] != importance[b] ? importance[a] > importance[b] : a < b;
+    };
+    std::partial_sort(ranked.begin(), ranked.begin() + residentCount, ranked.end(), moreImportant);
+    ranked.resize(residentCount);
+
+    // 3. 仍在前列的灯保留原槽位，其余槽位释放；新进入的灯取空闲槽位（内容待画）
+    const int kWanted = -2;
+    lightSlots.assign(lights.size(), -1);
+    for (int light : ranked) lightSlots[light] = kWanted;
+    for (int s = 0; s < kMaxPointShadows; ++s) {
+        Slot& slot = slots[s];
+        if (slot.light >= 0 && slot.light < lightCount && lightSlots[slot.light] == kWanted) {
+            lightSlots[slot.light] = s;
+        } else {
+            slot = Slot();
+        }
+    }
+    int freeSlot = 0;
+    for (int light : ranked) {
+        if (lightSlots[light] != kWanted) continue;
+        while (slots[freeSlot].light >= 0) ++freeSlot;
+        slots[freeSlot] = Slot();
+        slots[freeSlot].light = light;
+        lightSlots[light] = freeSlot;
+    }
+
+    // 4. 灯移动、半径变化或场景变化时槽位失效；失效的槽位按重要性取前 updateBudget 个重画
+    pendingSlots.clear();
+    for (int light : ranked) {
+        Slot& slot = slots[lightSlots[light]];
+        const float radius = ComputeLightRadius(lights[light]);
+        if (slot.valid && slot.position == lights[light].position && slot.radius == radius &&
+            slot.sceneRevision == sceneRevision) {
+            continue;
+        }
+        slot.valid = false;
+        if (static_cast<int>(pendingSlots.size()) < updateBudget) {
+            slot.valid = true;  // 本帧阴影 pass 中画好，主 pass 即可采样
+            slot.position = lights[light].position;
+            slot.radius = radius;
+            slot.sceneRevision = sceneRevision;
+            updateFaceMatrices(lightSlots[light], slot.position, radius);
+            pendingSlots.push_back(lightSlots[light]);
+        } else {
+            lightSlots[light] = -1;  // 排队中，暂时没有阴影
+        }
+    }
+
+    stats.resident = static_cast<unsigned int>(residentCount);
+    stats.ready = 0;
+    for (int light : ranked) {
+        if (lightSlots[light] >= 0) ++stats.ready;
+    }
+    stats.updated = static_cast<unsigned int>(pendingSlots.size());
+
+    PointShadowBlock block{};
+    for (int i = 0; i < kMaxPointShadows * 6; ++i) block.faceMatrices[i] = faceMatrices[i];
+    block.atlasParams = glm::vec4(1.0f / 6.0f, 1.0f / kMaxPointShadows, 1.0f / faceSize, static_cast<float>(faceSize));
+    pointShadowUniforms.Update(block);
+
+    stats.scheduleMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void PointShadowAtlas::BeginRender() {
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFBO);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_SCISSOR_TEST);  // glClear 只清除当前 tile
+    glCullFace(GL_FRONT);       // 与方向光阴影相同，使用正面剔除减少阴影失真
+    shader->use();
+}
+
+void PointShadowAtlas::BeginFace(int slot, int face) {
+    const GLint x = static_cast<GLint>(face * faceSize);
+    const GLint y = static_cast<GLint>(slot * faceSize);
+    glViewport(x, y, faceSize, faceSize);
+    glScissor(x, y, faceSize, faceSize);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    shader->use();
+    shader->setInt(kFaceIndexUniform, slot * 6 + face);
+}
+
+void PointShadowAtlas::EndRender() {
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glCullFace(GL_BACK);  // 恢复背面剔除
+}
@@ -0,0 +1,100 @@
+#ifndef POINT_SHADOWS_H
+#define POINT_SHADOWS_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ClusteredLighting.h"
+#include "FrustumCuller.h"
+#include "Shader.h"
+#include "UniformBuffers.h"
+
+struct PointShadowStats {
+    unsigned int candidates = 0;     // 影响范围与相机视锥体相交的点光源数
+    unsigned int resident = 0;       // 占有图集槽位的灯数
+    unsigned int ready = 0;          // 槽位内容有效（着色器会采样）的灯数
+    unsigned int updated = 0;        // 本帧重画的灯数（每盏 6 个面）
+    double scheduleMs = 0.0;         // CPU 排序和分配槽位的耗时
+};
+
+// 点光源（顶灯）的立方体阴影图集
+//  - GL 3.3 没有立方体贴图数组，6 个面作为 tile 放在一张深度纹理中：每个槽位占一行（+X -X +Y -Y +Z -Z），
+//    图集大小 6 * faceSize x kMaxPointShadows * faceSize，是固定的显存预算
+//  - 每帧按屏幕贡献（影响半径与到相机距离之比的平方，视锥体外为 0）给灯排序，前 kMaxPointShadows 盏占有槽位；
+//    仍在前列的灯保留原槽位，被挤出的灯释放槽位，新进入的灯取空闲槽位
+//  - 槽位内容按 (灯的位置、半径、场景版本) 缓存；失效的槽位按重要性排队，每帧最多重画 updateBudget 盏，
+//    其余沿用缓存的面。阴影开销由 updateBudget * 6 个面封顶，与场景中的灯数无关
+//  - 尚未画好的槽位不交给着色器（该灯暂时没有阴影），不会采样到旧灯的内容
+class PointShadowAtlas {
+public:
+    PointShadowAtlas() = default;
+    ~PointShadowAtlas();
+    PointShadowAtlas(const PointShadowAtlas&) = delete;
+    PointShadowAtlas& operator=(const PointShadowAtlas&) = delete;
+
+    // 创建图集深度纹理、FBO、点光源阴影着色器和 PointShadowBlock 的 uniform 缓冲
+    void Initialize(unsigned int faceSize = 512);
+    void Cleanup();
+
+    // 选出本帧占有槽位的灯并排出需要重画的槽位，上传各面的光源矩阵（每帧在阴影 pass 之前调用）
+    void Update(const std::vector<PointLight>& lights, const Frustum& cameraFrustum, const glm::vec3& cameraPosition,
+                uint64_t sceneRevision);
+
+    // 每盏灯的槽位（-1 为没有可用的阴影），下标与 Update 传入的灯光数组一致
+    const std::vector<int>& GetLightSlots() const { return lightSlots; }
+
+    // 本帧需要重画的槽位（按重要性排序，最多 updateBudget 个）
+    const std::vector<int>& GetPendingSlots() const { return pendingSlots; }
+
+    // 绑定 FBO 和着色器；之后对每个待画槽位的 6 个面调用 BeginFace 再提交绘制
+    void BeginRender();
+    void BeginFace(int slot, int face);
+    void EndRender();
+
+    // 槽位 slot 第 face 个面的光源矩阵（世界空间 -> 该面的裁剪空间）
+    const glm::mat4& GetFaceMatrix(int slot, int face) const { return faceMatrices[slot * 6 + face]; }
+
+    // 每帧最多重画的灯数
+    void SetUpdateBudget(int budget) { updateBudget = budget; }
+    int GetUpdateBudget() const { return updateBudget; }
+
+    // 丢弃所有槽位的内容（下一帧起按预算重新绘制）
+    void Invalidate();
+
+    unsigned int GetAtlasTexture() const { return atlasTexture; }
+    Shader* GetShader() const { return shader; }
+    const PointShadowStats& GetStats() const { return stats; }
+
+private:
+    struct Slot {
+        int light = -1;              // 占有该槽位的灯（-1 为空闲）
+        bool valid = false;          // 内容是否与下面的键一致
+        glm::vec3 position = glm::vec3(0.0f);
+        float radius = 0.0f;
+        uint64_t sceneRevision = 0;
+    };
+
+    // 灯的位置和影响半径决定 6 个面的投影（近平面固定，远平面为影响半径）
+    void updateFaceMatrices(int slot, const glm::vec3& position, float radius);
+
+    unsigned int faceSize = 512;
+    GLuint atlasFBO = 0;
+    GLuint atlasTexture = 0;
+    Shader* shader = nullptr;
+    UniformBuffer pointShadowUniforms;
+
+    Slot slots[kMaxPointShadows];
+    glm::mat4 faceMatrices[kMaxPointShadows * 6];
+    int updateBudget = 2;
+
+    // 每帧的临时数组
+    std::vector<float> importance;
+    std::vector<int> ranked;
+    std::vector<int> lightSlots;
+    std::vector<int> pendingSlots;
+
+    PointShadowStats stats;
+};
+
+#endif // POINT_SHADOWS_H
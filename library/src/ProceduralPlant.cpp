@@ -356,9 +356,9 @@ PottedPlant CreatePottedPlant(unsigned int seed) {
     const glm::vec3 leafColor = glm::vec3(0.10f, 0.55f, 0.20f) * (0.85f + uf01(rng) * 0.25f);
 
     PottedPlant plant;
-    plant.pot = std::make_shared<Mesh>(potVerts, potIdx);
-    plant.soil = std::make_shared<Mesh>(soilVerts, soilIdx);
-    plant.leaves = std::make_shared<Mesh>(leafVerts, leafIdx);
+    plant.pot = std::make_shared<Mesh>(std::move(potVerts), std::move(potIdx));
+    plant.soil = std::make_shared<Mesh>(std::move(soilVerts), std::move(soilIdx));
+    plant.leaves = std::make_shared<Mesh>(std::move(leafVerts), std::move(leafIdx));
 
     plant.potMat = CreateSolidPBRMaterial(potColor, 0.0f, 0.78f, 1.0f);
     plant.soilMat = CreateSolidPBRMaterial(soilColor, 0.0f, 1.0f, 1.0f);
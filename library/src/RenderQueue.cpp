@@ -0,0 +1,224 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+namespace {
+
+const int kProgramBits = 8;
+const int kMaterialBits = 16;
+const int kMeshBits = 16;
+const int kDepthBits = 24;
+const int kDepthShift = 0;
+const int kMeshShift = kDepthShift + kDepthBits;
+const int kMaterialShift = kMeshShift + kMeshBits;
+const int kProgramShift = kMaterialShift + kMaterialBits;
+static_assert(kProgramShift + kProgramBits == 64, "sort key fields must fill 64 bits");
+
+const float kMaxSortDepth = 100.0f;  // 与主相机远平面一致，更远的物体共用最大深度值
+const int kTextureUnits = 5;         // albedo / normal / metallic / roughness / ao
+
+const UniformHandle kUseGlossMapUniform("useGlossMap");
+const UniformHandle kMaterialAlbedoUniform("material.albedo");
+const UniformHandle kMaterialMetallicUniform("material.metallic");
+const UniformHandle kMaterialRoughnessUniform("material.roughness");
+const UniformHandle kMaterialAoUniform("material.ao");
+
+// 编号每帧重新分配，只有一帧内不同的着色器/材质/网格超过 256/65536/65536 个时才回绕（只影响排序质量，不影响正确性）
+inline uint64_t Field(uint64_t value, int bits, int shift) {
+    return (value & ((uint64_t(1) << bits) - 1)) << shift;
+}
+
+} // namespace
+
+RenderQueue::~RenderQueue() {
+    Release();
+}
+
+void RenderQueue::Release() {
+    if (instanceBuffer != 0) {
+        glDeleteBuffers(1, &instanceBuffer);
+        instanceBuffer = 0;
+    }
+    programIds.clear();
+    materialIds.clear();
+    meshIds.clear();
+}
+
+void RenderQueue::Begin(const glm::vec3& camPos) {
+    items.clear();
+    keys.clear();
+    // 排序编号只在一帧内有效：已销毁对象的地址可能被新对象复用，不能继承旧编号
+    programIds.clear();
+    materialIds.clear();
+    meshIds.clear();
+    cameraPosition = camPos;
+    stats = RenderQueueStats();
+}
+
+void RenderQueue::Add(Shader& shader, Mesh& mesh, const PBRTextureMaterial* material, bool useGloss, const glm::mat4& model) {
+    const InstanceData instance = MakeInstanceData(model);
+    Add(shader, mesh, material, useGloss, instance.model, instance.normalMatrix);
+}
+
+void RenderQueue::Add(Shader& shader, Mesh& mesh, const PBRTextureMaterial* material, bool useGloss,
+                      const glm::mat4& model, const glm::mat3& normalMatrix) {
+    const glm::vec3 position = glm::vec3(model[3]);
+    const float distance = glm::length(position - cameraPosition);
+    const float depth = std::min(distance / kMaxSortDepth, 1.0f);
+    const uint64_t depthKey = static_cast<uint64_t>(depth * static_cast<float>((1u << kDepthBits) - 1));
+
+    const uint64_t key = Field(programId(&shader), kProgramBits, kProgramShift) |
+                         Field(materialId(MaterialKey{ material, useGloss }), kMaterialBits, kMaterialShift) |
+                         Field(meshId(&mesh), kMeshBits, kMeshShift) |
+                         Field(depthKey, kDepthBits, kDepthShift);
+    keys.push_back(key);
+    DrawItem item{ &shader, &mesh, material, useGloss, InstanceData() };
+    item.instance.model = model;
+    item.instance.normalMatrix = normalMatrix;
+    item.instance.padding[0] = item.instance.padding[1] = item.instance.padding[2] = 0.0f;
+    items.push_back(item);
+}
+
+uint64_t RenderQueue::programId(const Shader* shader) {
+    auto it = programIds.find(shader);
+    if (it != programIds.end()) return it->second;
+    const uint64_t id = programIds.size();
+    programIds.emplace(shader, id);
+    return id;
+}
+
+uint64_t RenderQueue::materialId(const MaterialKey& key) {
+    auto it = materialIds.find(key);
+    if (it != materialIds.end()) return it->second;
+    const uint64_t id = materialIds.size();
+    materialIds.emplace(key, id);
+    return id;
+}
+
+uint64_t RenderQueue::meshId(const Mesh* mesh) {
+    auto it = meshIds.find(mesh);
+    if (it != meshIds.end()) return it->second;
+    const uint64_t id = meshIds.size();
+    meshIds.emplace(mesh, id);
+    return id;
+}
+
+// LSD 基数排序（每趟 8 位，共 8 趟），稳定；所有键在某一字节上相同时跳过该趟
+void RenderQueue::sortKeys() {
+    const size_t count = keys.size();
+    order.resize(count);
+    for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(i);
+    scratchKeys.resize(count);
+    scratchOrder.resize(count);
+
+    for (int pass = 0; pass < 8; ++pass) {
+        const int shift = pass * 8;
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; ++i) ++histogram[(keys[i] >> shift) & 0xFF];
+        if (histogram[(keys[0] >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            const size_t n = bucket;
+            bucket = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const size_t slot = histogram[(keys[i] >> shift) & 0xFF]++;
+            scratchKeys[slot] = keys[i];
+            scratchOrder[slot] = order[i];
+        }
+        keys.swap(scratchKeys);
+        order.swap(scratchOrder);
+    }
+}
+
+// 实例数据整块重新上传（glBufferData 让驱动换新存储，不等待上一帧仍在使用的旧数据）
+void RenderQueue::uploadInstances() {
+    instances.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        instances[i] = items[order[i]].instance;
+    }
+    if (instanceBuffer == 0) glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData), instances.data(), GL_STREAM_DRAW);
+}
+
+void RenderQueue::Submit() {
+    if (items.empty()) return;
+    sortKeys();
+    uploadInstances();
+
+    // 贴图绑定由队列自己跟踪；其他代码（ImGui、阴影贴图）可能改过纹理单元，每帧从未知状态开始
+    const Shader* currentShader = nullptr;
+    const PBRTextureMaterial* currentMaterial = nullptr;
+    bool currentGloss = false;
+    const Mesh* currentMesh = nullptr;
+    GLuint boundTextures[kTextureUnits] = {};
+    bool texturesKnown = false;
+
+    size_t first = 0;
+    while (first < order.size()) {
+        const DrawItem& item = items[order[first]];
+        Shader& shader = *item.shader;
+
+        // 与本项状态完全相同的后续项并入同一批
+        size_t last = first + 1;
+        while (last < order.size()) {
+            const DrawItem& next = items[order[last]];
+            if (next.shader != item.shader || next.mesh != item.mesh ||
+                next.material != item.material || next.useGloss != item.useGloss) break;
+            ++last;
+        }
+
+        // uniform 属于程序对象：切换程序后材质和网格 uniform 都要重新设置
+        if (&shader != currentShader) {
+            shader.use();
+            currentShader = &shader;
+            currentMaterial = nullptr;
+            currentMesh = nullptr;
+            ++stats.programSwitches;
+        }
+
+        if (item.material && (item.material != currentMaterial || item.useGloss != currentGloss)) {
+            const PBRTextureMaterial& mat = *item.material;
+            const GLuint textures[kTextureUnits] = { mat.albedoTex, mat.normalTex, mat.metallicTex, mat.roughnessTex, mat.aoTex };
+            for (int unit = 0; unit < kTextureUnits; ++unit) {
+                if (texturesKnown && boundTextures[unit] == textures[unit]) continue;
+                glActiveTexture(GL_TEXTURE0 + unit);
+                glBindTexture(GL_TEXTURE_2D, textures[unit]);
+                boundTextures[unit] = textures[unit];
+                ++stats.textureBinds;
+            }
+            texturesKnown = true;
+
+            // 设置是否使用GLOSS贴图（需要反转roughness）
+            shader.setBool(kUseGlossMapUniform, item.useGloss);
+            // 材质参数（真实值来自贴图，这些是乘子或默认值）
+            shader.setVec3(kMaterialAlbedoUniform, glm::vec3(1.0f));
+            shader.setFloat(kMaterialMetallicUniform, 0.0f);
+            shader.setFloat(kMaterialRoughnessUniform, 0.6f);
+            shader.setFloat(kMaterialAoUniform, 1.0f);
+
+            currentMaterial = item.material;
+            currentGloss = item.useGloss;
+            ++stats.materialChanges;
+        }
+
+        if (item.mesh != currentMesh) {
+            item.mesh->SetVertexUniforms(shader);
+            currentMesh = item.mesh;
+            ++stats.meshChanges;
+        }
+
+        const unsigned int count = static_cast<unsigned int>(last - first);
+        item.mesh->DrawInstanced(instanceBuffer, first, count);
+        ++stats.draws;
+        stats.instances += count;
+        if (item.material) stats.naiveTextureBinds += count * kTextureUnits;
+        first = last;
+    }
+
+    stats.naiveProgramSwitches = stats.instances;
+    Mesh::ResetVertexArrayBinding();
+}
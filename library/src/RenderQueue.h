@@ -0,0 +1,105 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+#include "Shader.h"
+#include "Texture.h"
+
+// 每帧的状态切换统计
+// draws 为实例化绘制批次数，instances 为入队的绘制项数
+// naive* 为逐个绘制时（每次都 use()、绑定 5 张贴图、设置材质和网格 uniform）会产生的次数
+struct RenderQueueStats {
+    unsigned int draws = 0;
+    unsigned int instances = 0;
+    unsigned int programSwitches = 0;
+    unsigned int textureBinds = 0;
+    unsigned int materialChanges = 0;
+    unsigned int meshChanges = 0;
+    unsigned int naiveProgramSwitches = 0;
+    unsigned int naiveTextureBinds = 0;
+};
+
+// 排序渲染队列：绘制项先入队，按 64 位键基数排序后提交，提交时跳过与上一项相同的状态
+// 键从高到低：程序（8 位）| 材质（16 位）| 网格（16 位）| 深度（24 位，由近到远）
+// 不透明物体在同一材质、同一网格内由近到远绘制，以便深度测试尽早剔除
+// 排序后程序、材质、网格都相同的连续项合并为一次实例化绘制：
+// 各项的 InstanceData 按排序顺序写入实例缓冲（每帧一次上传），批次数与实例数无关
+class RenderQueue {
+public:
+    RenderQueue() = default;
+    ~RenderQueue();
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // 开始新的一帧：清空队列，记录相机位置（用于深度键）
+    void Begin(const glm::vec3& camPos);
+
+    // 入队一个网格绘制；useGloss 属于材质状态（roughnessMap 为 GLOSS 贴图）
+    // material 为 nullptr 时不设置贴图和材质 uniform（阴影通道）
+    void Add(Shader& shader, Mesh& mesh, const PBRTextureMaterial* material, bool useGloss, const glm::mat4& model);
+
+    // 同上，法线矩阵由调用方提供（来自 EntityStore 的缓存，不再逐帧求逆）
+    void Add(Shader& shader, Mesh& mesh, const PBRTextureMaterial* material, bool useGloss,
+             const glm::mat4& model, const glm::mat3& normalMatrix);
+
+    // 排序并提交所有绘制项
+    void Submit();
+
+    // 释放实例缓冲（在 OpenGL 上下文销毁之前调用）
+    void Release();
+
+    const RenderQueueStats& GetStats() const { return stats; }
+    size_t Size() const { return items.size(); }
+
+private:
+    struct DrawItem {
+        Shader* shader;
+        Mesh* mesh;
+        const PBRTextureMaterial* material;
+        bool useGloss;
+        InstanceData instance;
+    };
+
+    // 材质由贴图和 GLOSS 标志共同决定
+    struct MaterialKey {
+        const PBRTextureMaterial* material;
+        bool useGloss;
+        bool operator==(const MaterialKey& other) const {
+            return material == other.material && useGloss == other.useGloss;
+        }
+    };
+    struct MaterialKeyHash {
+        size_t operator()(const MaterialKey& key) const {
+            return std::hash<const void*>()(key.material) ^ static_cast<size_t>(key.useGloss);
+        }
+    };
+
+    // 指针 -> 紧凑编号（按本帧首次出现的顺序分配，Begin 和 Release 时清空）
+    uint64_t programId(const Shader* shader);
+    uint64_t materialId(const MaterialKey& key);
+    uint64_t meshId(const Mesh* mesh);
+
+    void sortKeys();
+    void uploadInstances();
+
+    std::vector<DrawItem> items;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;     // 排序结果：items 的下标
+    std::vector<uint64_t> scratchKeys;
+    std::vector<uint32_t> scratchOrder;
+    std::vector<InstanceData> instances;  // 按排序顺序排列的实例数据
+    unsigned int instanceBuffer = 0;
+
+    std::unordered_map<const Shader*, uint64_t> programIds;
+    std::unordered_map<MaterialKey, uint64_t, MaterialKeyHash> materialIds;
+    std::unordered_map<const Mesh*, uint64_t> meshIds;
+
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    RenderQueueStats stats;
+};
+
+#endif // RENDER_QUEUE_H
@@ -1,34 +1,125 @@
 #include "Scene.h"
 #include <glad/glad.h>
+#include <chrono>
+#include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 #include "ShadowManager.h"
+#include "SceneFile.h"
+
+namespace {
+
+// 实体数达到该值后视锥体剔除改用 BVH（图书馆默认布局只有几十个实体）
+const size_t kBvhCullThreshold = 1024;
+
+// 每帧设置的 uniform 句柄（location 按着色器缓存，见 Shader.h）
+const UniformHandle kShadowBiasUniform("shadowBias");
+const UniformHandle kUseShadowsUniform("useShadows");
+const UniformHandle kShadowFilterUniform("shadowFilter");
+const UniformHandle kShadowLightSizeUniform("shadowLightSize");
+const UniformHandle kShadowPositiveExponentUniform("shadowPositiveExponent");
+const UniformHandle kShadowNegativeExponentUniform("shadowNegativeExponent");
+const UniformHandle kShadowLightBleedUniform("shadowLightBleed");
+const UniformHandle kShadowMinVarianceUniform("shadowMinVariance");
+
+// 分簇光照的三个 texture buffer 占用的第一个纹理单元（0-4 材质贴图，5 阴影贴图）
+const unsigned int kClusterTextureUnit = 6;
+
+// 按原始深度读取阴影贴图的纹理单元（同一张纹理 + 不比较的采样器对象）
+const unsigned int kShadowDepthTextureUnit = 9;
+
+// 点光源阴影图集的纹理单元
+const unsigned int kPointShadowTextureUnit = 10;
+
+// VSM / EVSM 矩纹理数组的纹理单元
+const unsigned int kShadowMomentTextureUnit = 11;
+
+Aabb ComputeBounds(const std::vector<Vertex>& vertices) {
+    Aabb bounds;
+    if (vertices.empty()) return bounds;
+    bounds.min = bounds.max = vertices[0].Pos;
+    for (const Vertex& v : vertices) {
+        bounds.min = glm::min(bounds.min, v.Pos);
+        bounds.max = glm::max(bounds.max, v.Pos);
+    }
+    return bounds;
+}
 
-Scene::Scene() 
-    : bookshelf(nullptr), libraryTable(nullptr), stool(nullptr), 
-      waterDispenser(nullptr), cube(nullptr), sphere(nullptr), ceilingLamp(nullptr),
-      virtualTime(12.0f),  // 默认中午12点
-      sunPosition(0.0f), sunDirection(0.0f) {
+} // namespace
+
+Scene::Scene()
+    : virtualTime(12.0f),  // 默认中午12点
+      sunDirection(0.0f) {
 }
 
 Scene::~Scene() {
-    delete bookshelf;
-    delete libraryTable;
-    delete stool;
-    delete waterDispenser;
-    delete cube;
-    delete sphere;
-    delete ceilingLamp;
+    Cleanup();
+}
+
+void Scene::Cleanup() {
+    // 释放 GL 资源，必须在 OpenGL 上下文销毁之前调用
+    entities.Clear();
+    models.clear();
+    plants.clear();
+    geometryArena.Release();
+    renderQueue.Release();
+    shadowQueue.Release();
+    occluderQueue.Release();
+    prepassQueue.Release();
+    occlusionCuller.Cleanup();
+    clusteredLights.Cleanup();
+    pointShadows.Cleanup();
+    pointShadowTimer.Cleanup();
+    samplesCounter.Cleanup();
+    fragmentCounter.Cleanup();
+    shadowPassTimer.Cleanup();
+    mainPassTimer.Cleanup();
+    prepassTimer.Cleanup();
+    frameUniforms.Cleanup();
+    directionalLightUniforms.Cleanup();
+}
+
+void Scene::buildGeometryArena() {
+    std::vector<Mesh*> staticMeshes;
+    for (auto& entry : models) {
+        for (Mesh& mesh : entry.second->meshes) staticMeshes.push_back(&mesh);
+    }
+    for (PottedPlant& plant : plants) {
+        staticMeshes.push_back(plant.pot.get());
+        staticMeshes.push_back(plant.soil.get());
+        staticMeshes.push_back(plant.leaves.get());
+    }
+
+    size_t vertexTotals[2] = { 0, 0 };
+    size_t indexTotals[2] = { 0, 0 };
+    for (const Mesh* mesh : staticMeshes) {
+        const size_t slot = mesh->format == VertexFormat::Packed ? 1 : 0;
+        vertexTotals[slot] += mesh->vertexCount;
+        indexTotals[slot] += mesh->indexCount;
+    }
+    if (vertexTotals[0] > 0) geometryArena.Reserve(VertexFormat::Float, vertexTotals[0], indexTotals[0]);
+    if (vertexTotals[1] > 0) geometryArena.Reserve(VertexFormat::Packed, vertexTotals[1], indexTotals[1]);
+
+    for (Mesh* mesh : staticMeshes) {
+        mesh->MoveToArena(geometryArena);
+    }
+    geometryArena.LogStats("STATS");
 }
 
-void Scene::Initialize() {
-    // ========= 加载所有模型 =========
-    bookshelf = new Model("models/bookshelf.obj");
-    libraryTable = new Model("models/library_table.obj");
-    stool = new Model("models/stool.obj");
-    waterDispenser = new Model("models/water_dispenser.obj");
-    cube = new Model("models/cube.obj");
-    sphere = new Model("models/sphere.obj");
-    ceilingLamp = new Model("models/ceiling_lamp.obj");
+void Scene::Initialize(const std::string& sceneFile) {
+    // ========= 每帧数据和灯光的 uniform 缓冲，点光源分簇缓冲 =========
+    frameUniforms.Initialize(kFrameBlockBinding, sizeof(FrameBlock));
+    directionalLightUniforms.Initialize(kDirectionalLightBlockBinding, sizeof(DirectionalLightBlock));
+    clusteredLights.Initialize();
+    pointShadows.Initialize(512);
+    pointShadowTimer.Initialize(GL_TIME_ELAPSED);
+
+    // ========= 遮挡剔除深度缓冲和 overdraw 统计 =========
+    occlusionCuller.Initialize();
+    samplesCounter.Initialize(GL_SAMPLES_PASSED);
+    if (HasPipelineStatisticsQuery()) fragmentCounter.Initialize(kFragmentShaderInvocationsQuery);
+    shadowPassTimer.Initialize(GL_TIME_ELAPSED);
+    mainPassTimer.Initialize(GL_TIME_ELAPSED);
+    prepassTimer.Initialize(GL_TIME_ELAPSED);
 
     // ========= 加载所有 PBR 材质 =========
     oakMat = LoadMaterial_WoodVeneerOak_7760();        // 橡木（用于书架、桌子）
@@ -38,500 +129,429 @@ void Scene::Initialize() {
     leatherMat = LoadMaterial_FabricLeatherCowhide_001(); // 皮革（用于椅子）
     tileMat = LoadMaterial_TilesTravertine_001();      // 大理石（用于墙面装饰）
 
-    // ========= 程序化生成盆栽（纯色PBR贴图，无需额外资源）=========
-    plants.reserve(6);
-    for (unsigned int i = 0; i < 6; ++i) {
-        plants.push_back(CreatePottedPlant(1000u + i));
+    // ========= 按场景文件加载模型、生成盆栽、创建实体 =========
+    loadSceneFile(sceneFile);
+
+    // ========= 静态网格合并到共享缓冲 =========
+    buildGeometryArena();
+
+    const MeshMemoryStats memory = Mesh::GetMemoryStats();
+    std::cout << "SCENE::MEMORY: meshes " << memory.meshCount
+              << " | GPU " << memory.gpuBytes / 1024 << " KB"
+              << " | CPU resident " << memory.cpuBytes / 1024 << " KB"
+              << " | CPU saved " << memory.cpuBytesSaved / 1024 << " KB" << std::endl;
+}
+
+void Scene::loadSceneFile(const std::string& path) {
+    SceneDescription description;
+    if (!LoadSceneDescription(path, description)) return;
+
+    // 场景模型上传后不再读取 CPU 端几何数据，释放以减少常驻内存
+    ModelLoadOptions loadOptions;
+    loadOptions.gpuOnly = true;
+    for (const SceneModelDesc& desc : description.models) {
+        models[desc.name] = std::make_unique<Model>(desc.path, loadOptions);
+    }
+
+    // 实体直接引用盆栽的材质，plants 之后不能再重新分配
+    size_t plantCount = 0;
+    for (const SceneObjectDesc& object : description.objects) {
+        if (object.isPlant) ++plantCount;
+    }
+    plants.reserve(plants.size() + plantCount);
+
+    std::vector<EntityDrawable> drawables;
+    for (const SceneObjectDesc& object : description.objects) {
+        uint8_t flags = 0;
+        if (object.castShadow) flags |= kEntityCastShadow;
+        if (object.useGloss) flags |= kEntityUseGloss;
+        if (object.occluder) flags |= kEntityOccluder;
+        drawables.clear();
+        Aabb bounds;
+
+        if (object.isPlant) {
+            // 程序化生成盆栽（纯色PBR贴图，无需额外资源）；包围盒在释放 CPU 几何数据之前计算
+            plants.push_back(CreatePottedPlant(object.plantSeed));
+            PottedPlant& plant = plants.back();
+            Mesh* parts[3] = { plant.pot.get(), plant.soil.get(), plant.leaves.get() };
+            const PBRTextureMaterial* materials[3] = { &plant.potMat, &plant.soilMat, &plant.leavesMat };
+            bounds = ComputeBounds(parts[0]->vertices);
+            for (int i = 0; i < 3; ++i) {
+                const Aabb partBounds = ComputeBounds(parts[i]->vertices);
+                bounds.min = glm::min(bounds.min, partBounds.min);
+                bounds.max = glm::max(bounds.max, partBounds.max);
+                parts[i]->ReleaseCpuGeometry();
+                drawables.push_back(EntityDrawable{ parts[i], materials[i] });
+            }
+        } else {
+            auto model = models.find(object.model);
+            const PBRTextureMaterial* material = findMaterial(object.material);
+            if (model == models.end() || !material) {
+                std::cerr << "WARNING::SCENE::UNKNOWN_REFERENCE: model '" << object.model
+                          << "', material '" << object.material << "' in " << path << std::endl;
+                continue;
+            }
+            bounds.min = model->second->boundsMin;
+            bounds.max = model->second->boundsMax;
+            for (Mesh& mesh : model->second->meshes) {
+                drawables.push_back(EntityDrawable{ &mesh, material });
+            }
+        }
+
+        entities.Create(object.position, object.rotation, object.scale, bounds, flags,
+                        drawables.data(), drawables.size());
+    }
+    entities.UpdateTransforms();
+
+    pointLights.clear();
+    for (const SceneLightDesc& desc : description.lights) {
+        PointLight light;
+        light.position = desc.position;
+        light.color = desc.color;
+        light.intensity = desc.intensity;
+        pointLights.push_back(light);
     }
 }
 
-void Scene::SetupLighting(Shader& pbrShader) {
-    // ========= 设置 PBR 光照系统（6个点光源营造图书馆氛围）=========
-    // 天花板位置：wallHeight + floorTopY + floorThickness * 0.5f = 5.0 + 0.05 + 0.05 = 5.1f
-    // 光源位置与顶灯模型位置一致，悬挂在天花板下方
-    const float wallHeight = 5.0f;
-    const float floorThickness = 0.1f;
-    const float floorTopY = floorThickness * 0.5f;
-    const float ceilingHeight = wallHeight + floorTopY + floorThickness * 0.5f;  // 5.1f
-    const float lampHeight = ceilingHeight - 0.3f;  // 4.8f
-    
-    pbrShader.use();
-    
-    // 设置顶灯（0-5），全天都亮
-    int baseLightCount = 6;
-    
-    // 主灯光（中央上方，暖白色）
-    pbrShader.setVec3("lights[0].position", glm::vec3(0.0f, lampHeight, 0.0f));
-    pbrShader.setVec3("lights[0].color", glm::vec3(1.0f, 0.95f, 0.85f));
-    pbrShader.setFloat("lights[0].intensity", 50.0f);
-    
-    // 左侧灯光（书架区域）
-    pbrShader.setVec3("lights[1].position", glm::vec3(-5.0f, lampHeight, 0.0f));
-    pbrShader.setVec3("lights[1].color", glm::vec3(1.0f, 0.98f, 0.9f));
-    pbrShader.setFloat("lights[1].intensity", 40.0f);
-    
-    // 右侧灯光（书架区域）
-    pbrShader.setVec3("lights[2].position", glm::vec3(5.0f, lampHeight, 0.0f));
-    pbrShader.setVec3("lights[2].color", glm::vec3(1.0f, 0.98f, 0.9f));
-    pbrShader.setFloat("lights[2].intensity", 40.0f);
-    
-    // 前方灯光（阅读区）
-    pbrShader.setVec3("lights[3].position", glm::vec3(0.0f, lampHeight, -4.0f));
-    pbrShader.setVec3("lights[3].color", glm::vec3(0.95f, 0.98f, 1.0f));
-    pbrShader.setFloat("lights[3].intensity", 35.0f);
-    
-    // 后方灯光
-    pbrShader.setVec3("lights[4].position", glm::vec3(0.0f, lampHeight, 4.0f));
-    pbrShader.setVec3("lights[4].color", glm::vec3(0.9f, 0.95f, 1.0f));
-    pbrShader.setFloat("lights[4].intensity", 30.0f);
-    
-    // 角落灯光（饮水机区域，稍冷色调）
-    pbrShader.setVec3("lights[5].position", glm::vec3(6.0f, lampHeight, 6.0f));
-    pbrShader.setVec3("lights[5].color", glm::vec3(0.85f, 0.9f, 1.0f));
-    pbrShader.setFloat("lights[5].intensity", 25.0f);
-    
-    // ========= 添加来自外界的方向光（自然光）=========
+void Scene::updateEntities() {
+    if (entities.UpdateTransforms() > 0 || culler.Count() != entities.Count()) {
+        culler.SetBounds(entities.GetWorldBoundsData(), entities.Count());
+        bvh.Build(entities.GetWorldBoundsData(), entities.Count());
+        ++sceneRevision;  // 缓存的阴影贴图失效
+
+        bool first = true;
+        for (unsigned int entity = 0; entity < entities.Count(); ++entity) {
+            if (!(entities.GetFlags(entity) & kEntityCastShadow)) continue;
+            const Aabb& box = entities.GetWorldBounds(entity);
+            shadowCasterBounds.min = first ? box.min : glm::min(shadowCasterBounds.min, box.min);
+            shadowCasterBounds.max = first ? box.max : glm::max(shadowCasterBounds.max, box.max);
+            first = false;
+        }
+    }
+}
+
+void Scene::cullEntities(const Frustum& frustum) {
+    if (entities.Count() < kBvhCullThreshold) {
+        culler.Cull(frustum, visibleEntities);
+        return;
+    }
+    visibleEntities.clear();
+    bvh.QueryFrustum(frustum, visibleEntities);
+}
+
+bool Scene::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                    unsigned int& entity, float& distance) const {
+    BvhRayHit hit;
+    if (!bvh.Raycast(origin, direction, maxDistance, hit)) return false;
+    entity = hit.primitive;
+    distance = hit.distance;
+    return true;
+}
+
+const PBRTextureMaterial* Scene::findMaterial(const std::string& name) const {
+    if (name == "oak") return &oakMat;
+    if (name == "woodFloor") return &woodFloorMat;
+    if (name == "metal") return &metalMat;
+    if (name == "paintedMetal") return &paintedMetalMat;
+    if (name == "leather") return &leatherMat;
+    if (name == "tile") return &tileMat;
+    return nullptr;
+}
+
+void Scene::SetupLighting() {
+    // 顶灯等点光源来自场景文件，由分簇光照处理（见 Render）
+    // ========= 来自外界的方向光（自然光）=========
     // 根据虚拟时间计算太阳方向（24小时内绕场景一圈）
     sunDirection = CalculateSunDirection(virtualTime);
-    
-    // 使用远距离点光源模拟方向光
-    // 位置：在太阳方向的很远的地方，模拟方向光
-    const float sunDistance = 15.0f;  // 模拟方向光
-    sunPosition = -sunDirection * sunDistance;  // 光源位置在太阳方向的相反方向
-    
-    // 根据时间调整太阳颜色和强度（平滑过渡）
+
+    // 根据时间调整太阳颜色和照度（平滑过渡）
     glm::vec3 sunColor;
     float sunIntensity;
     CalculateSunLight(virtualTime, sunColor, sunIntensity);
-    
-    // 注意：由于shader只支持点光源，我们使用远距离点光源来模拟方向光
-    // 在实际应用中，应该修改shader添加真正的方向光支持
-    // 这里为了不修改shader，使用一个非常远的点光源
-    // 自然光始终放在lights[6]（顶灯在0-5）
-    pbrShader.setInt("lightCount", baseLightCount + 1);  // 6个顶灯 + 1个自然光
-    
-    // 自然光放在lights[6]
-    pbrShader.setVec3("lights[6].position", sunPosition);
-    pbrShader.setVec3("lights[6].color", sunColor);
-    pbrShader.setFloat("lights[6].intensity", sunIntensity);
 
-    // 绑定采样器编号（纹理单元）
+    // 方向光没有衰减；方向在这里归一化一次，着色器直接使用（内容不变时不上传）
+    DirectionalLightBlock block{};
+    block.direction = glm::normalize(-sunDirection);
+    block.shadowMapIndex = 0;
+    block.radiance = sunColor * sunIntensity;
+    directionalLightUniforms.Update(block);
+}
+
+void Scene::BindSamplers(Shader& pbrShader) {
+    // 绑定采样器编号（纹理单元），只需在着色器创建后设置一次
+    pbrShader.use();
     pbrShader.setInt("albedoMap",    0);
     pbrShader.setInt("normalMap",    1);
     pbrShader.setInt("metallicMap",  2);
     pbrShader.setInt("roughnessMap", 3);
     pbrShader.setInt("aoMap",        4);
+    pbrShader.setInt("shadowMap",    5);  // 阴影贴图
+    pbrShader.setInt("shadowDepthMap", kShadowDepthTextureUnit);
+    pbrShader.setInt("pointShadowAtlas", kPointShadowTextureUnit);
+    pbrShader.setInt("shadowMomentMap", kShadowMomentTextureUnit);
+    pbrShader.setInt("clusterLightData",    kClusterTextureUnit);      // 分簇光照
+    pbrShader.setInt("clusterGrid",         kClusterTextureUnit + 1);
+    pbrShader.setInt("clusterLightIndices", kClusterTextureUnit + 2);
 }
 
-void Scene::Render(Shader& pbrShader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos) {
-    // 更新 PBR shader 的矩阵和相机
-    pbrShader.use();
-    pbrShader.setMat4("view", view);
-    pbrShader.setMat4("projection", projection);
-    pbrShader.setVec3("camPos", camPos);
-
-    // ========= 渲染地板 =========
-    glm::mat4 floorMatrix = glm::mat4(1.0f);
-    floorMatrix = glm::translate(floorMatrix, glm::vec3(0.0f, 0.0f, 0.0f));
-    floorMatrix = glm::scale(floorMatrix, glm::vec3(15.0f, 0.1f, 15.0f));  // 大尺寸地板
-    renderModelWithPBRMaterial(pbrShader, *cube, woodFloorMat, floorMatrix);
-
-    // ========= 渲染墙壁与天花板（围合空间）=========
-    const float roomSize = 15.0f;
-    const float halfRoom = roomSize * 0.5f;
-    const float wallThickness = 0.2f;
-    const float wallHeight = 5.0f;
-    const float floorThickness = 0.1f;
-    const float floorTopY = floorThickness * 0.5f;
-
-    // ========= 渲染盆栽（放在地面上）=========
-    const glm::vec3 plantPositions[6] = {
-        glm::vec3(-6.0f, floorTopY, -5.5f),
-        glm::vec3(-6.0f, floorTopY,  0.0f),
-        glm::vec3(-6.0f, floorTopY,  5.5f),
-        glm::vec3( 6.0f, floorTopY, -5.5f),
-        glm::vec3( 6.0f, floorTopY,  0.0f),
-        glm::vec3( 4.2f, floorTopY,  4.2f)  // 避开饮水机(5.5,5.5)
-    };
-    const float plantRotY[6] = { 25.0f, -10.0f, 55.0f, -35.0f, 15.0f, -60.0f };
-
-    for (int i = 0; i < 6; ++i) {
-        glm::mat4 plantM = glm::mat4(1.0f);
-        plantM = glm::translate(plantM, plantPositions[i]);
-        plantM = glm::rotate(plantM, glm::radians(plantRotY[i]), glm::vec3(0.0f, 1.0f, 0.0f));
-
-        renderMeshWithPBRMaterial(pbrShader, *plants[i].pot, plants[i].potMat, plantM);
-        renderMeshWithPBRMaterial(pbrShader, *plants[i].soil, plants[i].soilMat, plantM);
-        renderMeshWithPBRMaterial(pbrShader, *plants[i].leaves, plants[i].leavesMat, plantM);
+void Scene::UpdateFrameUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos,
+                                float time, ShadowManager& shadowManager) {
+    // 级联要在阴影 pass 之前按本帧相机拟合（ShadowManager 自己上传 ShadowBlock）
+    updateEntities();
+    shadowManager.UpdateCascades(view, projection, sunDirection, shadowCasterBounds);
+
+    cameraPosition = camPos;
+    cameraView = view;
+    cameraProjection = projection;
+    cameraViewProjection = projection * view;
+    cameraFrustum = ExtractFrustum(cameraViewProjection);
+    for (int i = 0; i < shadowManager.GetCascadeCount(); ++i) {
+        cascadeFrusta[i] = ExtractFrustum(shadowManager.GetCascadeMatrix(i));
     }
 
-    // 左墙（x 负方向）
-    glm::mat4 leftWallMatrix = glm::mat4(1.0f);
-    leftWallMatrix = glm::translate(leftWallMatrix, glm::vec3(-(halfRoom + wallThickness * 0.5f), wallHeight * 0.5f + floorTopY, 0.0f));
-    leftWallMatrix = glm::scale(leftWallMatrix, glm::vec3(wallThickness, wallHeight, roomSize));
-    renderModelWithPBRMaterial(pbrShader, *cube, tileMat, leftWallMatrix, true);
+    // 点光源阴影槽位按本帧相机重新分配（槽位随灯光数据一起交给分簇光照）
+    pointShadows.Update(pointLights, cameraFrustum, camPos, sceneRevision);
 
-    // 落地窗（x 正方向，替代右墙）
-    // 使用金属材质模拟窗框，创建一个大的落地窗结构
-    const float windowFrameThickness = 0.05f;
-    const float windowHeight = wallHeight;
-    
-    // 窗框 - 顶部横梁
-    glm::mat4 windowTopFrame = glm::mat4(1.0f);
-    windowTopFrame = glm::translate(windowTopFrame, glm::vec3((halfRoom + windowFrameThickness * 0.5f), wallHeight * 0.5f + floorTopY, 0.0f));
-    windowTopFrame = glm::scale(windowTopFrame, glm::vec3(windowFrameThickness, windowFrameThickness * 0.3f, roomSize));
-    renderModelWithPBRMaterial(pbrShader, *cube, metalMat, windowTopFrame);
-    
-    // 窗框 - 底部横梁
-    glm::mat4 windowBottomFrame = glm::mat4(1.0f);
-    windowBottomFrame = glm::translate(windowBottomFrame, glm::vec3((halfRoom + windowFrameThickness * 0.5f), floorTopY + windowFrameThickness * 0.15f, 0.0f));
-    windowBottomFrame = glm::scale(windowBottomFrame, glm::vec3(windowFrameThickness, windowFrameThickness * 0.3f, roomSize));
-    renderModelWithPBRMaterial(pbrShader, *cube, metalMat, windowBottomFrame);
-    
-    // 窗框 - 左侧竖框
-    glm::mat4 windowLeftFrame = glm::mat4(1.0f);
-    windowLeftFrame = glm::translate(windowLeftFrame, glm::vec3((halfRoom + windowFrameThickness * 0.5f), wallHeight * 0.5f + floorTopY, -(halfRoom - windowFrameThickness * 0.5f)));
-    windowLeftFrame = glm::scale(windowLeftFrame, glm::vec3(windowFrameThickness, windowHeight, windowFrameThickness));
-    renderModelWithPBRMaterial(pbrShader, *cube, metalMat, windowLeftFrame);
-    
-    // 窗框 - 右侧竖框
-    glm::mat4 windowRightFrame = glm::mat4(1.0f);
-    windowRightFrame = glm::translate(windowRightFrame, glm::vec3((halfRoom + windowFrameThickness * 0.5f), wallHeight * 0.5f + floorTopY, (halfRoom - windowFrameThickness * 0.5f)));
-    windowRightFrame = glm::scale(windowRightFrame, glm::vec3(windowFrameThickness, windowHeight, windowFrameThickness));
-    renderModelWithPBRMaterial(pbrShader, *cube, metalMat, windowRightFrame);
-    
-    // 窗框 - 中间竖框（分割成两扇窗）
-    glm::mat4 windowMiddleFrame = glm::mat4(1.0f);
-    windowMiddleFrame = glm::translate(windowMiddleFrame, glm::vec3((halfRoom + windowFrameThickness * 0.5f), wallHeight * 0.5f + floorTopY, 0.0f));
-    windowMiddleFrame = glm::scale(windowMiddleFrame, glm::vec3(windowFrameThickness, windowHeight, windowFrameThickness));
-    renderModelWithPBRMaterial(pbrShader, *cube, metalMat, windowMiddleFrame);
-
-    // 后墙（z 正方向）
-    glm::mat4 backWallMatrix = glm::mat4(1.0f);
-    backWallMatrix = glm::translate(backWallMatrix, glm::vec3(0.0f, wallHeight * 0.5f + floorTopY, (halfRoom + wallThickness * 0.5f)));
-    backWallMatrix = glm::scale(backWallMatrix, glm::vec3(roomSize, wallHeight, wallThickness));
-    renderModelWithPBRMaterial(pbrShader, *cube, tileMat, backWallMatrix, true);
-
-    // 前墙（z 负方向）
-    glm::mat4 frontWallMatrix = glm::mat4(1.0f);
-    frontWallMatrix = glm::translate(frontWallMatrix, glm::vec3(0.0f, wallHeight * 0.5f + floorTopY, -(halfRoom + wallThickness * 0.5f)));
-    frontWallMatrix = glm::scale(frontWallMatrix, glm::vec3(roomSize, wallHeight, wallThickness));
-    renderModelWithPBRMaterial(pbrShader, *cube, tileMat, frontWallMatrix, true);
-
-    // 天花板
-    glm::mat4 ceilingMatrix = glm::mat4(1.0f);
-    ceilingMatrix = glm::translate(ceilingMatrix, glm::vec3(0.0f, wallHeight + floorTopY + floorThickness * 0.5f, 0.0f));
-    ceilingMatrix = glm::scale(ceilingMatrix, glm::vec3(roomSize, floorThickness, roomSize));
-    renderModelWithPBRMaterial(pbrShader, *cube, tileMat, ceilingMatrix, true);
-
-    // ========= 渲染顶灯（在每个光源位置）=========
-    // 天花板位置：wallHeight + floorTopY + floorThickness * 0.5f = 5.0 + 0.05 + 0.05 = 5.1f
-    // 顶灯悬挂在天花板下方，y坐标设为4.8f
-    const float ceilingHeight = wallHeight + floorTopY + floorThickness * 0.5f;  // 5.1f
-    const float lampHeight = ceilingHeight - 0.3f;  // 4.8f，让顶灯悬挂在天花板下方
-    
-    const glm::vec3 lightPositions[6] = {
-        glm::vec3(0.0f, lampHeight, 0.0f),      // 主灯光
-        glm::vec3(-5.0f, lampHeight, 0.0f),    // 左侧灯光
-        glm::vec3(5.0f, lampHeight, 0.0f),     // 右侧灯光
-        glm::vec3(0.0f, lampHeight, -4.0f),    // 前方灯光
-        glm::vec3(0.0f, lampHeight, 4.0f),     // 后方灯光
-        glm::vec3(6.0f, lampHeight, 6.0f)      // 角落灯光
-    };
-    
-    for (int i = 0; i < 6; ++i) {
-        glm::mat4 lampMatrix = glm::mat4(1.0f);
-        lampMatrix = glm::translate(lampMatrix, lightPositions[i]);
-        lampMatrix = glm::scale(lampMatrix, glm::vec3(0.3f));
-        renderModelWithPBRMaterial(pbrShader, *ceilingLamp, metalMat, lampMatrix);
-    }
+    FrameBlock block{};
+    block.view = view;
+    block.projection = projection;
+    block.camPos = camPos;
+    block.time = time;
+    frameUniforms.Update(block);
+}
 
-    // ========= 渲染桌子，每排3张桌子以短边相连 =========
+void Scene::Render(Shader& pbrShader) {
+    // 相机矩阵和位置来自 FrameBlock（UpdateFrameUniforms）
+    // 与相机视锥体相交且未被遮挡的实体进入渲染队列，最后按 程序/材质/网格/深度 排序后统一提交
+    updateEntities();
+    cullEntities(cameraFrustum);
+
+    // 视锥体内的遮挡物留给本帧的遮挡物 pass（不受旧金字塔影响，避免剔除结果自我强化）
+    if (occlusionCullingEnabled) occlusionCuller.Update();
+    occluderEntities.clear();
+    size_t kept = 0;
+    unsigned int occluded = 0;
+    for (unsigned int entity : visibleEntities) {
+        if (entities.GetFlags(entity) & kEntityOccluder) occluderEntities.push_back(entity);
+        if (occlusionCullingEnabled && !occlusionCuller.IsVisible(entities.GetWorldBounds(entity))) {
+            ++occluded;
+            continue;
+        }
+        visibleEntities[kept++] = entity;
+    }
+    visibleEntities.resize(kept);
+
+    cullingStats.total = static_cast<unsigned int>(entities.Count());
+    cullingStats.cameraVisible = static_cast<unsigned int>(visibleEntities.size());
+    cullingStats.occluded = occluded;
+    renderQueue.Begin(cameraPosition);
+
+    for (unsigned int entity : visibleEntities) {
+        const bool useGloss = (entities.GetFlags(entity) & kEntityUseGloss) != 0;
+        const EntityDrawable* drawables = entities.GetDrawables(entity);
+        for (unsigned int i = 0; i < entities.GetDrawableCount(entity); ++i) {
+            renderQueue.Add(pbrShader, *drawables[i].mesh, drawables[i].material, useGloss,
+                            entities.GetWorldMatrix(entity), entities.GetNormalMatrix(entity));
+        }
+    }
 
-    const float tableShortEdge = 1.5f;  // 短边（x方向）
-    const float tableLongEdge = 2.5f;   // 长边（z方向）
-    const float tableSpacing = 0.1f;    // 桌子之间的间距（控制排内桌子间的距离）
-    const int numRows = 3;              // 3排桌子
-    const int tablesPerRow = 3;         // 每排3张桌子
-    const float rowSpacing = 4.0f;      // 排之间的间距（只影响 x 方向，不影响排内桌子间距离）
-    const float startX = -5.0f;         // 起始x位置
-    const float startZ = -5.0f;        // 起始z位置
-    
-    for (int row = 0; row < numRows; ++row) {
-        float rowX = startX + row * rowSpacing;
-        
-        // 渲染每排的3张桌子（沿z方向，短边相连）
-        for (int table = 0; table < tablesPerRow; ++table) {
-            float tableZ = startZ + table * (tableLongEdge + tableSpacing) + tableLongEdge * 0.5f;
-            
-            glm::mat4 tableMatrix = glm::mat4(1.0f);
-            tableMatrix = glm::translate(tableMatrix, glm::vec3(rowX, 0.0f, tableZ));
-            tableMatrix = glm::scale(tableMatrix, glm::vec3(1.2f));
-            renderModelWithPBRMaterial(pbrShader, *libraryTable, oakMat, tableMatrix);
+    if (depthPrepassEnabled) {
+        // 深度预渲染：只写深度；之后主 pass 只着色深度完全相等（即最终可见）的片元
+        Shader& depthShader = *occlusionCuller.GetDepthShader();
+        prepassQueue.Begin(cameraPosition);
+        for (unsigned int entity : visibleEntities) {
+            const EntityDrawable* drawables = entities.GetDrawables(entity);
+            for (unsigned int i = 0; i < entities.GetDrawableCount(entity); ++i) {
+                prepassQueue.Add(depthShader, *drawables[i].mesh, nullptr, false,
+                                 entities.GetWorldMatrix(entity), entities.GetNormalMatrix(entity));
+            }
         }
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        prepassTimer.Begin();
+        prepassQueue.Submit();
+        prepassTimer.End();
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_EQUAL);
     }
 
-    // ========= 渲染椅子（独立定义位置，不依赖于桌子）=========
-    // 椅子位置定义：每排桌子长边两侧各放置椅子
-    // 第1排（row=0, x=-5.0）：左侧椅子
-    const glm::vec3 chairPositions[] = {
-        // 第1排左侧椅子（x=-5.0，面向x正方向）
-        glm::vec3(-6.2f, 0.0f, -4.5f), glm::vec3(-6.2f, 0.0f, -2.0f), glm::vec3(-6.2f, 0.0f, 0.5f), glm::vec3(-6.2f, 0.0f, 3.0f),
-        // 第1排右侧椅子（x=-5.0，面向x负方向）
-        glm::vec3(-3.8f, 0.0f, -4.5f), glm::vec3(-3.8f, 0.0f, -2.0f), glm::vec3(-3.8f, 0.0f, 0.5f), glm::vec3(-3.8f, 0.0f, 3.0f),
-        // 第2排左侧椅子（x=-1.0，面向x正方向）
-        glm::vec3(-2.2f, 0.0f, -4.5f), glm::vec3(-2.2f, 0.0f, -2.0f), glm::vec3(-2.2f, 0.0f, 0.5f), glm::vec3(-2.2f, 0.0f, 3.0f),
-        // 第2排右侧椅子（x=-1.0，面向x负方向）
-        glm::vec3(0.2f, 0.0f, -4.5f), glm::vec3(0.2f, 0.0f, -2.0f), glm::vec3(0.2f, 0.0f, 0.5f), glm::vec3(0.2f, 0.0f, 3.0f),
-        // 第3排左侧椅子（x=3.0，面向x正方向）
-        glm::vec3(1.8f, 0.0f, -4.5f), glm::vec3(1.8f, 0.0f, -2.0f), glm::vec3(1.8f, 0.0f, 0.5f), glm::vec3(1.8f, 0.0f, 3.0f),
-        // 第3排右侧椅子（x=3.0，面向x负方向）
-        glm::vec3(4.2f, 0.0f, -4.5f), glm::vec3(4.2f, 0.0f, -2.0f), glm::vec3(4.2f, 0.0f, 0.5f), glm::vec3(4.2f, 0.0f, 3.0f)
-    };
-    
-    const float chairRotations[] = {
-        // 所有椅子都面朝-z方向（旋转180度）
-        180.0f, 180.0f, 180.0f, 180.0f,  // 第1排左侧椅子
-        180.0f, 180.0f, 180.0f, 180.0f,  // 第1排右侧椅子
-        180.0f, 180.0f, 180.0f, 180.0f,  // 第2排左侧椅子
-        180.0f, 180.0f, 180.0f, 180.0f,  // 第2排右侧椅子
-        180.0f, 180.0f, 180.0f, 180.0f,  // 第3排左侧椅子
-        180.0f, 180.0f, 180.0f, 180.0f   // 第3排右侧椅子
-    };
-    
-    const int totalChairs = sizeof(chairPositions) / sizeof(chairPositions[0]);
-    for (int i = 0; i < totalChairs; ++i) {
-        glm::mat4 stoolMatrix = glm::mat4(1.0f);
-        stoolMatrix = glm::translate(stoolMatrix, chairPositions[i]);
-        stoolMatrix = glm::rotate(stoolMatrix, glm::radians(chairRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
-        stoolMatrix = glm::scale(stoolMatrix, glm::vec3(1.0f));
-        renderModelWithPBRMaterial(pbrShader, *stool, leatherMat, stoolMatrix, true);
+    // 点光源按主 pass 的视口分簇（深度预渲染不需要灯光）
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    clusteredLights.Update(pointLights, cameraView, cameraProjection, viewport[2], viewport[3],
+                           &pointShadows.GetLightSlots());
+    clusteredLights.Bind(kClusterTextureUnit);
+
+    mainPassTimer.Begin();
+    samplesCounter.Begin();
+    fragmentCounter.Begin();
+    renderQueue.Submit();
+    fragmentCounter.End();
+    samplesCounter.End();
+    mainPassTimer.End();
+
+    if (depthPrepassEnabled) {
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_LESS);
     }
 
-    // ========= 渲染6排书架，每排2个书架背靠背，放在每排桌子的一端 =========
-    // 书架垂直于墙面（沿x方向），放在桌子的一端（z方向的一端）
-    const float bookshelfDepth = 1.0f;  // 书架深度
-    const float bookshelfSpacing = 0.1f; // 两个书架之间的间距
-    
-    for (int row = 0; row < numRows; ++row) {
-        float rowX = startX + row * rowSpacing;
-        float bookshelfZ = startZ - 1.5f;  // 放在桌子的一端（z负方向）
-        
-        // 第一个书架（面向z正方向）
-        glm::mat4 bookshelf1Matrix = glm::mat4(1.0f);
-        bookshelf1Matrix = glm::translate(bookshelf1Matrix, glm::vec3(rowX + 0.2f, 0.0f, bookshelfZ + 0.09f));
-        bookshelf1Matrix = glm::rotate(bookshelf1Matrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.f));
-        bookshelf1Matrix = glm::scale(bookshelf1Matrix, glm::vec3(1.15f));
-        renderModelWithPBRMaterial(pbrShader, *bookshelf, oakMat, bookshelf1Matrix);
-        
-        // 第二个书架（背靠背，面向z负方向）
-        glm::mat4 bookshelf2Matrix = glm::mat4(1.0f);
-        bookshelf2Matrix = glm::translate(bookshelf2Matrix, glm::vec3(rowX - 0.22f, 0.0f, bookshelfZ - bookshelfDepth - bookshelfSpacing + 1.2f));
-        bookshelf2Matrix = glm::rotate(bookshelf2Matrix, glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        bookshelf2Matrix = glm::scale(bookshelf2Matrix, glm::vec3(1.15f));
-        renderModelWithPBRMaterial(pbrShader, *bookshelf, oakMat, bookshelf2Matrix);
+    if (occlusionCullingEnabled && occlusionCuller.CanCaptureOccluders()) renderOccluders();
+}
+
+void Scene::renderOccluders() {
+    occlusionCuller.BeginOccluderPass(cameraViewProjection);
+    Shader& depthShader = *occlusionCuller.GetDepthShader();
+    occluderQueue.Begin(cameraPosition);
+    for (unsigned int entity : occluderEntities) {
+        const EntityDrawable* drawables = entities.GetDrawables(entity);
+        for (unsigned int i = 0; i < entities.GetDrawableCount(entity); ++i) {
+            occluderQueue.Add(depthShader, *drawables[i].mesh, nullptr, false,
+                              entities.GetWorldMatrix(entity), entities.GetNormalMatrix(entity));
+        }
     }
+    occluderQueue.Submit();
+    occlusionCuller.EndOccluderPass();
+}
+
+bool Scene::GetFragmentInvocations(uint64_t& invocations) const {
+    if (!fragmentCounter.IsInitialized()) return false;
+    invocations = fragmentCounter.GetResult();
+    return true;
+}
 
-    // ========= 渲染饮水机（角落）=========
-    glm::mat4 dispenserMatrix = glm::mat4(1.0f);
-    dispenserMatrix = glm::translate(dispenserMatrix, glm::vec3(5.5f, 0.0f, 5.5f));
-    dispenserMatrix = glm::rotate(dispenserMatrix, glm::radians(-45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    dispenserMatrix = glm::scale(dispenserMatrix, glm::vec3(1.0f));
-    renderModelWithPBRMaterial(pbrShader, *waterDispenser, metalMat, dispenserMatrix);
+void Scene::SetOcclusionCulling(bool enabled) {
+    occlusionCullingEnabled = enabled;
+    if (!enabled) occlusionCuller.Invalidate();
 }
 
+
 void Scene::RenderShadowMap(ShadowManager& shadowManager) {
+    // 计时包住整个阴影 pass（包括被缓存跳过的帧，此时 GPU 耗时接近 0）
+    using Clock = std::chrono::high_resolution_clock;
+    const auto start = Clock::now();
+    shadowPassTimer.Begin();
+
+    // 光源矩阵和场景都没变的级保留上一次的内容；所有级都有效时整个 pass 跳过
+    updateEntities();
+    shadowCascadesRendered = 0;
+    for (int cascade = 0; cascade < shadowManager.GetCascadeCount(); ++cascade) {
+        if (!shadowManager.IsCascadeCached(cascade, sceneRevision)) ++shadowCascadesRendered;
+    }
+    shadowStats = RenderQueueStats();
+    if (shadowCascadesRendered == 0) {
+        cullingStats.lightVisible = 0;  // 本帧没有剔除阴影投射物，不沿用上一次重画时的统计
+        shadowPassTimer.End();
+        shadowPassCpuMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return;
+    }
+
     // 开始渲染阴影贴图
-    shadowManager.BeginShadowMapRender(sunPosition, sunDirection, true);
+    shadowManager.BeginShadowMapRender();
 
     Shader* shadowShader = shadowManager.GetShadowShader();
-    
-    // 渲染所有需要投射阴影的物体（不包括顶灯）
-    // ========= 渲染地板 =========
-    glm::mat4 floorMatrix = glm::mat4(1.0f);
-    floorMatrix = glm::translate(floorMatrix, glm::vec3(0.0f, 0.0f, 0.0f));
-    floorMatrix = glm::scale(floorMatrix, glm::vec3(15.0f, 0.1f, 15.0f));
-    shadowShader->setMat4("model", floorMatrix);
-    cube->Draw(*shadowShader);
-
-    // ========= 渲染桌子 =========
-    const float tableShortEdge = 1.5f;
-    const float tableLongEdge = 2.5f;
-    const float tableSpacing = 0.1f;
-    const int numRows = 3;
-    const int tablesPerRow = 3;
-    const float rowSpacing = 4.0f;
-    const float startX = -5.0f;
-    const float startZ = -5.0f;
-    
-    for (int row = 0; row < numRows; ++row) {
-        float rowX = startX + row * rowSpacing;
-        for (int table = 0; table < tablesPerRow; ++table) {
-            float tableZ = startZ + table * (tableLongEdge + tableSpacing) + tableLongEdge * 0.5f;
-            glm::mat4 tableMatrix = glm::mat4(1.0f);
-            tableMatrix = glm::translate(tableMatrix, glm::vec3(rowX, 0.0f, tableZ));
-            tableMatrix = glm::scale(tableMatrix, glm::vec3(1.2f));
-            shadowShader->setMat4("model", tableMatrix);
-            libraryTable->Draw(*shadowShader);
-        }
-    }
 
-    // ========= 渲染椅子 =========
-    const glm::vec3 chairPositions[] = {
-        glm::vec3(-6.2f, 0.0f, -4.5f), glm::vec3(-6.2f, 0.0f, -2.0f), glm::vec3(-6.2f, 0.0f, 0.5f), glm::vec3(-6.2f, 0.0f, 3.0f),
-        glm::vec3(-3.8f, 0.0f, -4.5f), glm::vec3(-3.8f, 0.0f, -2.0f), glm::vec3(-3.8f, 0.0f, 0.5f), glm::vec3(-3.8f, 0.0f, 3.0f),
-        glm::vec3(-2.2f, 0.0f, -4.5f), glm::vec3(-2.2f, 0.0f, -2.0f), glm::vec3(-2.2f, 0.0f, 0.5f), glm::vec3(-2.2f, 0.0f, 3.0f),
-        glm::vec3(0.2f, 0.0f, -4.5f), glm::vec3(0.2f, 0.0f, -2.0f), glm::vec3(0.2f, 0.0f, 0.5f), glm::vec3(0.2f, 0.0f, 3.0f),
-        glm::vec3(1.8f, 0.0f, -4.5f), glm::vec3(1.8f, 0.0f, -2.0f), glm::vec3(1.8f, 0.0f, 0.5f), glm::vec3(1.8f, 0.0f, 3.0f),
-        glm::vec3(4.2f, 0.0f, -4.5f), glm::vec3(4.2f, 0.0f, -2.0f), glm::vec3(4.2f, 0.0f, 0.5f), glm::vec3(4.2f, 0.0f, 3.0f)
-    };
-    
-    const float chairRotations[] = {
-        180.0f, 180.0f, 180.0f, 180.0f,
-        180.0f, 180.0f, 180.0f, 180.0f,
-        180.0f, 180.0f, 180.0f, 180.0f,
-        180.0f, 180.0f, 180.0f, 180.0f,
-        180.0f, 180.0f, 180.0f, 180.0f,
-        180.0f, 180.0f, 180.0f, 180.0f
-    };
-    
-    const int totalChairs = sizeof(chairPositions) / sizeof(chairPositions[0]);
-    for (int i = 0; i < totalChairs; ++i) {
-        glm::mat4 stoolMatrix = glm::mat4(1.0f);
-        stoolMatrix = glm::translate(stoolMatrix, chairPositions[i]);
-        stoolMatrix = glm::rotate(stoolMatrix, glm::radians(chairRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
-        stoolMatrix = glm::scale(stoolMatrix, glm::vec3(1.0f));
-        shadowShader->setMat4("model", stoolMatrix);
-        stool->Draw(*shadowShader);
-    }
+    // 每一级只取与该级光源视锥体相交且投射阴影的实体（墙壁、天花板、顶灯等不投射）
+    // 同一网格的多个实例合并为一次实例化绘制，阴影通道不需要材质
+    casterVisible.assign(entities.Count(), 0);
 
-    // ========= 渲染书架 =========
-    const float bookshelfDepth = 1.0f;
-    const float bookshelfSpacing = 0.1f;
-    
-    for (int row = 0; row < numRows; ++row) {
-        float rowX = startX + row * rowSpacing;
-        float bookshelfZ = startZ - 1.5f;
-        
-        glm::mat4 bookshelf1Matrix = glm::mat4(1.0f);
-        bookshelf1Matrix = glm::translate(bookshelf1Matrix, glm::vec3(rowX + 0.2f, 0.0f, bookshelfZ + 0.09f));
-        bookshelf1Matrix = glm::rotate(bookshelf1Matrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.f));
-        bookshelf1Matrix = glm::scale(bookshelf1Matrix, glm::vec3(1.15f));
-        shadowShader->setMat4("model", bookshelf1Matrix);
-        bookshelf->Draw(*shadowShader);
-        
-        glm::mat4 bookshelf2Matrix = glm::mat4(1.0f);
-        bookshelf2Matrix = glm::translate(bookshelf2Matrix, glm::vec3(rowX - 0.22f, 0.0f, bookshelfZ - bookshelfDepth - bookshelfSpacing + 1.2f));
-        bookshelf2Matrix = glm::rotate(bookshelf2Matrix, glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        bookshelf2Matrix = glm::scale(bookshelf2Matrix, glm::vec3(1.15f));
-        shadowShader->setMat4("model", bookshelf2Matrix);
-        bookshelf->Draw(*shadowShader);
+    unsigned int casters = 0;
+    unsigned int visibleCasters = 0;
+    for (unsigned int entity = 0; entity < entities.Count(); ++entity) {
+        if (entities.GetFlags(entity) & kEntityCastShadow) ++casters;
     }
-
-    // ========= 渲染饮水机 =========
-    glm::mat4 dispenserMatrix = glm::mat4(1.0f);
-    dispenserMatrix = glm::translate(dispenserMatrix, glm::vec3(5.5f, 0.0f, 5.5f));
-    dispenserMatrix = glm::rotate(dispenserMatrix, glm::radians(-45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    dispenserMatrix = glm::scale(dispenserMatrix, glm::vec3(1.0f));
-    shadowShader->setMat4("model", dispenserMatrix);
-    waterDispenser->Draw(*shadowShader);
-
-    // ========= 渲染盆栽 =========
-    const float wallHeight = 5.0f;
-    const float floorThickness = 0.1f;
-    const float floorTopY = floorThickness * 0.5f;
-    const glm::vec3 plantPositions[6] = {
-        glm::vec3(-6.0f, floorTopY, -5.5f),
-        glm::vec3(-6.0f, floorTopY,  0.0f),
-        glm::vec3(-6.0f, floorTopY,  5.5f),
-        glm::vec3( 6.0f, floorTopY, -5.5f),
-        glm::vec3( 6.0f, floorTopY,  0.0f),
-        glm::vec3( 4.2f, floorTopY,  4.2f)
-    };
-    const float plantRotY[6] = { 25.0f, -10.0f, 55.0f, -35.0f, 15.0f, -60.0f };
-
-    for (int i = 0; i < 6; ++i) {
-        glm::mat4 plantM = glm::mat4(1.0f);
-        plantM = glm::translate(plantM, plantPositions[i]);
-        plantM = glm::rotate(plantM, glm::radians(plantRotY[i]), glm::vec3(0.0f, 1.0f, 0.0f));
-        shadowShader->setMat4("model", plantM);
-        plants[i].pot->Draw(*shadowShader);
-        plants[i].soil->Draw(*shadowShader);
-        plants[i].leaves->Draw(*shadowShader);
+    for (int cascade = 0; cascade < shadowManager.GetCascadeCount(); ++cascade) {
+        if (shadowManager.IsCascadeCached(cascade, sceneRevision)) continue;
+        shadowManager.BeginCascade(cascade, sceneRevision);
+        cullEntities(cascadeFrusta[cascade]);
+        shadowQueue.Begin(cameraPosition);
+        for (unsigned int entity : visibleEntities) {
+            if (!(entities.GetFlags(entity) & kEntityCastShadow)) continue;
+            if (!casterVisible[entity]) {
+                casterVisible[entity] = 1;
+                ++visibleCasters;
+            }
+            const EntityDrawable* drawables = entities.GetDrawables(entity);
+            for (unsigned int i = 0; i < entities.GetDrawableCount(entity); ++i) {
+                shadowQueue.Add(*shadowShader, *drawables[i].mesh, nullptr, false,
+                                entities.GetWorldMatrix(entity), entities.GetNormalMatrix(entity));
+            }
+        }
+        shadowQueue.Submit();
+
+        const RenderQueueStats& stats = shadowQueue.GetStats();
+        shadowStats.draws += stats.draws;
+        shadowStats.instances += stats.instances;
+        shadowStats.programSwitches += stats.programSwitches;
+        shadowStats.meshChanges += stats.meshChanges;
+        shadowStats.naiveProgramSwitches += stats.naiveProgramSwitches;
     }
+    cullingStats.shadowCasters = casters;
+    cullingStats.lightVisible = visibleCasters;
 
     // 结束阴影贴图渲染
     shadowManager.EndShadowMapRender();
+
+    shadowPassTimer.End();
+    shadowPassCpuMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
 }
 
-void Scene::SetupShadowUniforms(Shader& pbrShader, ShadowManager& shadowManager) {
-    pbrShader.use();
-    
-    // 设置光源空间矩阵
-    pbrShader.setMat4("lightSpaceMatrix", shadowManager.GetLightSpaceMatrix());
-    
-    // 设置阴影参数
-    pbrShader.setFloat("shadowBias", shadowManager.GetShadowBias());
-    pbrShader.setBool("useShadows", true);
-    
-    // 绑定阴影贴图到纹理单元5
-    pbrShader.setInt("shadowMap", 5);
-    glActiveTexture(GL_TEXTURE5);
-    glBindTexture(GL_TEXTURE_2D, shadowManager.GetShadowMapTexture());
+void Scene::RenderPointShadows() {
+    // 只画 PointShadowAtlas::Update 排出的槽位；静止场景中所有槽位画好之后不再有任何绘制
+    pointShadowTimer.Begin();
+    const std::vector<int>& pending = pointShadows.GetPendingSlots();
+    if (!pending.empty()) {
+        pointShadows.BeginRender();
+        Shader* shader = pointShadows.GetShader();
+        for (int slot : pending) {
+            for (int face = 0; face < 6; ++face) {
+                pointShadows.BeginFace(slot, face);
+                cullEntities(ExtractFrustum(pointShadows.GetFaceMatrix(slot, face)));
+                shadowQueue.Begin(cameraPosition);
+                for (unsigned int entity : visibleEntities) {
+                    if (!(entities.GetFlags(entity) & kEntityCastShadow)) continue;
+                    const EntityDrawable* drawables = entities.GetDrawables(entity);
+                    for (unsigned int i = 0; i < entities.GetDrawableCount(entity); ++i) {
+                        shadowQueue.Add(*shader, *drawables[i].mesh, nullptr, false,
+                                        entities.GetWorldMatrix(entity), entities.GetNormalMatrix(entity));
+                    }
+                }
+                shadowQueue.Submit();
+            }
+        }
+        pointShadows.EndRender();
+    }
+    pointShadowTimer.End();
 }
 
-void Scene::renderModelWithPBRMaterial(Shader& pbrShader, Model& model, PBRTextureMaterial& mat, 
-                                       glm::mat4& modelMatrix, bool useGloss) {
+void Scene::SetupShadowUniforms(Shader& pbrShader, ShadowManager& shadowManager) {
     pbrShader.use();
-    pbrShader.setMat4("model", modelMatrix);
-    
-    // 设置是否使用GLOSS贴图（需要反转roughness）
-    pbrShader.setBool("useGlossMap", useGloss);
-    
-    // 绑定材质纹理
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mat.albedoTex);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, mat.normalTex);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, mat.metallicTex);
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, mat.roughnessTex);
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_2D, mat.aoTex);
-    
-    // 材质参数（真实值来自贴图，这些是乘子或默认值）
-    pbrShader.setVec3("material.albedo", glm::vec3(1.0f));
-    pbrShader.setFloat("material.metallic", 0.0f);
-    pbrShader.setFloat("material.roughness", 0.6f);
-    pbrShader.setFloat("material.ao", 1.0f);
     
-    model.Draw(pbrShader);
-}
+    // 级联矩阵和分段深度在 ShadowBlock 中（ShadowManager::UpdateCascades）
 
-void Scene::renderMeshWithPBRMaterial(Shader& pbrShader, Mesh& mesh, PBRTextureMaterial& mat,
-                                      glm::mat4& modelMatrix, bool useGloss) {
-    pbrShader.use();
-    pbrShader.setMat4("model", modelMatrix);
-    pbrShader.setBool("useGlossMap", useGloss);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mat.albedoTex);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, mat.normalTex);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, mat.metallicTex);
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, mat.roughnessTex);
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_2D, mat.aoTex);
-
-    pbrShader.setVec3("material.albedo", glm::vec3(1.0f));
-    pbrShader.setFloat("material.metallic", 0.0f);
-    pbrShader.setFloat("material.roughness", 0.6f);
-    pbrShader.setFloat("material.ao", 1.0f);
-
-    mesh.Draw(pbrShader);
+    // 设置阴影参数
+    pbrShader.setFloat(kShadowBiasUniform, shadowManager.GetShadowBias());
+    pbrShader.setBool(kUseShadowsUniform, true);
+    pbrShader.setInt(kShadowFilterUniform, static_cast<int>(shadowManager.GetFilter()));
+    pbrShader.setFloat(kShadowLightSizeUniform, shadowManager.GetLightSize());
+    pbrShader.setFloat(kShadowPositiveExponentUniform, shadowManager.GetEvsmPositiveExponent());
+    pbrShader.setFloat(kShadowNegativeExponentUniform, shadowManager.GetEvsmNegativeExponent());
+    pbrShader.setFloat(kShadowLightBleedUniform, shadowManager.GetLightBleedReduction());
+    pbrShader.setFloat(kShadowMinVarianceUniform, shadowManager.GetMinVariance());
+    
+    // 绑定级联阴影贴图数组到纹理单元5（深度比较），同一张纹理再以原始深度绑定到另一个单元（采样器编号见 BindSamplers）
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowManager.GetShadowMapTexture());
+    glActiveTexture(GL_TEXTURE0 + kShadowDepthTextureUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowManager.GetShadowMapTexture());
+    glBindSampler(kShadowDepthTextureUnit, shadowManager.GetDepthSampler());
+
+    // 点光源阴影图集
+    glActiveTexture(GL_TEXTURE0 + kPointShadowTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, pointShadows.GetAtlasTexture());
+
+    // VSM / EVSM 的矩（未使用时为 0，着色器不会采样）
+    glActiveTexture(GL_TEXTURE0 + kShadowMomentTextureUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowManager.GetMomentTexture());
 }
 
 void Scene::SetTime(float hour) {
@@ -593,11 +613,12 @@ bool Scene::IsDaytime(float hour) const {
 
 void Scene::CalculateSunLight(float hour, glm::vec3& outColor, float& outIntensity) const {
     // 定义阳光和月光的颜色和强度
+    // 照度按原先 15 米外点光源的强度（3000 / 10）在场景中心的值折算：I / 15²
     const glm::vec3 dayColor = glm::vec3(1.0f, 0.98f, 0.95f);  // 温暖的阳光色
-    const float dayIntensity = 3000.0f;
-    
+    const float dayIntensity = 3000.0f / 225.0f;
+
     const glm::vec3 nightColor = glm::vec3(0.7f, 0.75f, 0.9f);  // 较弱的月光色
-    const float nightIntensity = 10.0f;
+    const float nightIntensity = 10.0f / 225.0f;
     
     float t = 0.0f;  // 插值参数，0为夜晚，1为白天
     
@@ -1,6 +1,9 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <glm/glm.hpp>
 #include "Model.h"
@@ -9,6 +12,16 @@
 #include "Texture.h"
 #include "ProceduralPlant.h"
 #include "ShadowManager.h"
+#include "PointShadows.h"
+#include "GeometryArena.h"
+#include "UniformBuffers.h"
+#include "RenderQueue.h"
+#include "EntityStore.h"
+#include "FrustumCuller.h"
+#include "Bvh.h"
+#include "OcclusionCuller.h"
+#include "GpuCounters.h"
+#include "ClusteredLighting.h"
 
 // 场景类：管理所有场景对象、材质和光照
 class Scene {
@@ -16,18 +29,76 @@ public:
     Scene();
     ~Scene();
 
-    // 初始化场景（加载模型、材质等）
-    void Initialize();
+    // 初始化场景（加载材质，按场景文件加载模型、创建实体和点光源）
+    void Initialize(const std::string& sceneFile);
 
-    // 设置光照（在渲染前调用）
-    void SetupLighting(Shader& pbrShader);
+    // 释放模型和盆栽网格（在 glfwTerminate 之前调用）
+    void Cleanup();
 
-    // 渲染场景
-    void Render(Shader& pbrShader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos);
+    // 设置光照（在渲染前调用）：计算太阳方向，更新 DirectionalLightBlock（点光源由分簇光照处理）
+    void SetupLighting();
 
-    // 渲染阴影贴图（从光源视角）
+    // 设置 PBR 着色器的采样器编号（着色器创建后调用一次）
+    void BindSamplers(Shader& pbrShader);
+
+    // 更新 FrameBlock（相机、时间）并按相机拟合阴影级联，在 SetupLighting 之后、阴影 pass 之前每帧调用一次
+    void UpdateFrameUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos,
+                             float time, ShadowManager& shadowManager);
+
+    // 渲染场景（经排序渲染队列提交）；点光源按当前视口分簇
+    void Render(Shader& pbrShader);
+
+    // 上一帧主场景的绘制/状态切换统计
+    const RenderQueueStats& GetRenderStats() const { return renderQueue.GetStats(); }
+    const RenderQueueStats& GetShadowRenderStats() const { return shadowStats; }
+    const CullingStats& GetCullingStats() const { return cullingStats; }
+
+    // 遮挡剔除开关（关闭时丢弃旧的深度金字塔）
+    void SetOcclusionCulling(bool enabled);
+    bool IsOcclusionCullingEnabled() const { return occlusionCullingEnabled; }
+
+    // 深度预渲染：先用深度着色器写入深度，主 pass 以 GL_EQUAL 测试且不写深度，每个像素只着色一次
+    void SetDepthPrepass(bool enabled) { depthPrepassEnabled = enabled; }
+    bool IsDepthPrepassEnabled() const { return depthPrepassEnabled; }
+
+    // 上一次可用的主场景通过深度测试的样本数（除以屏幕像素数即 overdraw）
+    uint64_t GetSamplesPassed() const { return samplesCounter.GetResult(); }
+
+    // 主 pass 的片元着色器调用次数（驱动不支持 GL_ARB_pipeline_statistics_query 时返回 false）
+    bool GetFragmentInvocations(uint64_t& invocations) const;
+
+    // 主 pass 的 GPU 耗时（毫秒，计时查询晚一两帧；阴影过滤核的开销主要体现在这里）
+    double GetMainPassGpuMs() const { return mainPassTimer.GetResult() / 1.0e6; }
+
+    // 深度预渲染的 GPU 耗时（毫秒，关闭时为 0）；与主 pass 相加才能和关闭预渲染时的主 pass 耗时对比
+    double GetPrepassGpuMs() const { return depthPrepassEnabled ? prepassTimer.GetResult() / 1.0e6 : 0.0; }
+
+    const RenderQueueStats& GetPrepassStats() const { return prepassQueue.GetStats(); }
+
+    // 上一帧点光源分簇统计（含 CPU 分簇耗时）
+    const ClusterStats& GetClusterStats() const { return clusteredLights.GetStats(); }
+
+    // 射线拾取：返回 maxDistance 内世界包围盒最先被命中的实体（按包围盒，不做三角形测试）
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 unsigned int& entity, float& distance) const;
+
+    // 渲染级联阴影贴图（从光源视角，每级一层）；光源矩阵和场景都没变的级直接沿用缓存
     void RenderShadowMap(ShadowManager& shadowManager);
 
+    // 上一帧阴影 pass 重画的级数和耗时（GPU 耗时来自计时查询，晚一两帧）
+    int GetShadowCascadesRendered() const { return shadowCascadesRendered; }
+    double GetShadowPassCpuMs() const { return shadowPassCpuMs; }
+    double GetShadowPassGpuMs() const { return shadowPassTimer.GetResult() / 1.0e6; }
+
+    // 渲染点光源阴影图集中本帧待画的槽位（每盏灯 6 个面），在 RenderShadowMap 之后调用
+    void RenderPointShadows();
+
+    // 点光源阴影：每帧最多重画的灯数、上一帧统计和 GPU 耗时
+    void SetPointShadowBudget(int budget) { pointShadows.SetUpdateBudget(budget); }
+    int GetPointShadowBudget() const { return pointShadows.GetUpdateBudget(); }
+    const PointShadowStats& GetPointShadowStats() const { return pointShadows.GetStats(); }
+    double GetPointShadowGpuMs() const { return pointShadowTimer.GetResult() / 1.0e6; }
+
     // 设置阴影相关uniform（在渲染前调用）
     void SetupShadowUniforms(Shader& pbrShader, ShadowManager& shadowManager);
 
@@ -41,14 +112,8 @@ public:
     glm::vec4 CalculateBackgroundColor(float hour) const;
 
 private:
-    // 场景模型
-    Model* bookshelf;
-    Model* libraryTable;
-    Model* stool;
-    Model* waterDispenser;
-    Model* cube;
-    Model* sphere;
-    Model* ceilingLamp;
+    // 场景模型（名称来自场景文件的 model 行）
+    std::map<std::string, std::unique_ptr<Model>> models;
 
     // PBR 材质
     PBRTextureMaterial oakMat;
@@ -61,11 +126,88 @@ private:
     // 程序化生成的盆栽
     std::vector<PottedPlant> plants;
 
+    // 场景中所有物体（模型实例和盆栽）的变换、包围盒和绘制部件
+    EntityStore entities;
+
+    // 按世界包围盒对相机和各级阴影的视锥体剔除（视锥体在 UpdateFrameUniforms 中更新）
+    // 实体较少时逐个 SIMD 测试更快；数量达到 kBvhCullThreshold 后改用 BVH 查询
+    FrustumCuller culler;
+    Bvh bvh;
+    Frustum cameraFrustum;
+    Frustum cascadeFrusta[kMaxShadowCascades];
+    std::vector<unsigned int> visibleEntities;
+    CullingStats cullingStats;
+    glm::mat4 cameraView = glm::mat4(1.0f);
+    glm::mat4 cameraProjection = glm::mat4(1.0f);
+    glm::mat4 cameraViewProjection = glm::mat4(1.0f);
+
+    // 场景文件中的点光源，每帧按相机分簇后上传（着色器只遍历片元所在簇的灯）
+    std::vector<PointLight> pointLights;
+    ClusteredLights clusteredLights;
+
+    // 点光源阴影图集（按屏幕贡献分配槽位，每帧限量重画）
+    PointShadowAtlas pointShadows;
+    GpuQueryCounter pointShadowTimer;
+
+    // Hi-Z 遮挡剔除：主 pass 之后渲染视锥体内的遮挡物深度，下一帧用于剔除
+    OcclusionCuller occlusionCuller;
+    RenderQueue occluderQueue;
+    std::vector<unsigned int> occluderEntities;
+    bool occlusionCullingEnabled = true;
+
+    // 深度预渲染（使用遮挡剔除的深度着色器）
+    RenderQueue prepassQueue;
+    bool depthPrepassEnabled = false;
+
+    // 主 pass 的样本计数（overdraw 统计）、片元着色器调用次数和 GPU 耗时
+    GpuQueryCounter samplesCounter;
+    GpuQueryCounter fragmentCounter;
+    GpuQueryCounter mainPassTimer;
+    GpuQueryCounter prepassTimer;
+
+    // 重新计算 dirty 实体的变换；包围盒有变化时同步到剔除器并重建 BVH
+    void updateEntities();
+
+    // 与视锥体相交的实体下标写入 visibleEntities
+    void cullEntities(const Frustum& frustum);
+
+    // 把 occluderEntities 渲染到遮挡剔除的深度缓冲并开始回读
+    void renderOccluders();
+
+    // 所有静态网格（模型 + 盆栽）共用的顶点/索引缓冲
+    GeometryArena geometryArena;
+
+    // pbr / shadow 着色器共享的 std140 uniform 缓冲
+    UniformBuffer frameUniforms;
+    UniformBuffer directionalLightUniforms;
+
+    // 主场景和阴影通道的排序渲染队列（各自持有实例缓冲）
+    RenderQueue renderQueue;
+    RenderQueue shadowQueue;
+    RenderQueueStats shadowStats;             // 各级阴影之和
+    std::vector<uint8_t> casterVisible;       // 本帧至少进入一级阴影的实体
+    Aabb shadowCasterBounds;                  // 投射阴影实体的包围盒（级联正交投影的近平面）
+
+    // 实体变换或包围盒每变化一次加一（阴影缓存键的一部分）
+    uint64_t sceneRevision = 0;
+    int shadowCascadesRendered = 0;
+    double shadowPassCpuMs = 0.0;
+    GpuQueryCounter shadowPassTimer;
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+    // 读取场景文件：加载其中的模型，生成盆栽，创建实体
+    void loadSceneFile(const std::string& path);
+
+    // 场景文件中的材质名 -> 材质；未知名称返回 nullptr
+    const PBRTextureMaterial* findMaterial(const std::string& name) const;
+
+    // 把所有静态网格移入 geometryArena（先按总量预留，避免逐个扩容）
+    void buildGeometryArena();
+
     // 虚拟时间（0-24小时，默认12点）
     float virtualTime;
 
-    // 太阳位置和方向（用于阴影计算）
-    glm::vec3 sunPosition;
+    // 太阳方向（光线传播方向）
     glm::vec3 sunDirection;
 
     // 根据时间计算太阳方向
@@ -76,14 +218,6 @@ private:
 
     // 根据时间计算太阳光的颜色和强度（平滑过渡）
     void CalculateSunLight(float hour, glm::vec3& outColor, float& outIntensity) const;
-
-    // 辅助函数：使用PBR材质渲染模型
-    void renderModelWithPBRMaterial(Shader& pbrShader, Model& model, PBRTextureMaterial& mat, 
-                                     glm::mat4& modelMatrix, bool useGloss = false);
-
-    // 辅助函数：使用PBR材质渲染 Mesh（用于程序化生成物体）
-    void renderMeshWithPBRMaterial(Shader& pbrShader, Mesh& mesh, PBRTextureMaterial& mat,
-                                    glm::mat4& modelMatrix, bool useGloss = false);
 };
 
 #endif
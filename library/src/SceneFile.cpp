@@ -0,0 +1,107 @@
+#include "SceneFile.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+bool ReadVec3(std::istringstream& in, glm::vec3& out) {
+    return static_cast<bool>(in >> out.x >> out.y >> out.z);
+}
+
+// scale 后跟 1 个（均匀缩放）或 3 个数
+bool ReadScale(std::istringstream& in, glm::vec3& out) {
+    float s = 0.0f;
+    if (!(in >> s)) return false;
+    out = glm::vec3(s);
+    const std::streampos mark = in.tellg();
+    float y = 0.0f;
+    float z = 0.0f;
+    if (in >> y >> z) {
+        out = glm::vec3(s, y, z);
+    } else {
+        in.clear();
+        in.seekg(mark);
+    }
+    return true;
+}
+
+// 解析行尾的可选属性；遇到未知关键字或缺少数值时返回 false
+bool ReadObjectAttributes(std::istringstream& in, SceneObjectDesc& object) {
+    std::string key;
+    while (in >> key) {
+        bool ok = true;
+        if (key == "gloss") object.useGloss = true;
+        else if (key == "noshadow") object.castShadow = false;
+        else if (key == "occluder") object.occluder = true;
+        else if (key == "position") ok = ReadVec3(in, object.position);
+        else if (key == "rotation") ok = ReadVec3(in, object.rotation);
+        else if (key == "scale") ok = ReadScale(in, object.scale);
+        else ok = false;
+        if (!ok) return false;
+    }
+    return true;
+}
+
+bool ReadLightAttributes(std::istringstream& in, SceneLightDesc& light) {
+    std::string key;
+    while (in >> key) {
+        bool ok = true;
+        if (key == "position") ok = ReadVec3(in, light.position);
+        else if (key == "color") ok = ReadVec3(in, light.color);
+        else if (key == "intensity") ok = static_cast<bool>(in >> light.intensity);
+        else ok = false;
+        if (!ok) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool LoadSceneDescription(const std::string& path, SceneDescription& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SCENE_FILE::FILE_OPEN_FAILED: " << path << std::endl;
+        return false;
+    }
+
+    out = SceneDescription();
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword)) continue;
+
+        bool ok = false;
+        if (keyword == "model") {
+            SceneModelDesc model;
+            ok = static_cast<bool>(in >> model.name >> model.path);
+            if (ok) out.models.push_back(model);
+        } else if (keyword == "object") {
+            SceneObjectDesc object;
+            ok = (in >> object.model >> object.material) && ReadObjectAttributes(in, object);
+            if (ok) out.objects.push_back(object);
+        } else if (keyword == "plant") {
+            SceneObjectDesc object;
+            object.isPlant = true;
+            ok = (in >> object.plantSeed) && ReadObjectAttributes(in, object);
+            if (ok) out.objects.push_back(object);
+        } else if (keyword == "light") {
+            SceneLightDesc light;
+            ok = ReadLightAttributes(in, light);
+            if (ok) out.lights.push_back(light);
+        }
+        if (!ok) {
+            std::cerr << "WARNING::SCENE_FILE::INVALID_LINE: " << path << ":" << lineNumber << ": " << line << std::endl;
+        }
+    }
+    std::cout << "SCENE_FILE::LOADED: " << path << " | Models: " << out.models.size()
+              << " | Objects: " << out.objects.size() << " | Lights: " << out.lights.size() << std::endl;
+    return true;
+}
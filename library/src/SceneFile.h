@@ -0,0 +1,51 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 场景描述文件（文本格式，每行一条，# 开头为注释）：
+//   model <名称> <OBJ 路径>
+//   object <模型名> <材质名> [gloss] [noshadow] [occluder] [position x y z] [rotation x y z] [scale s | scale x y z]
+//   plant <种子> [noshadow] [position x y z] [rotation x y z] [scale s | scale x y z]
+//   light [position x y z] [color r g b] [intensity i]
+// occluder 标记的物体（墙、书架等大而不透明的物体）写入遮挡剔除用的深度缓冲
+// rotation 为角度，按 Y、X、Z 顺序旋转（世界矩阵 = T * Ry * Rx * Rz * S）
+// light 为点光源（平方反比衰减，影响半径由颜色和强度求出，见 ClusteredLighting.h）
+// 材质名由 Scene 解析（见 Scene::findMaterial），文件本身不检查
+
+struct SceneModelDesc {
+    std::string name;
+    std::string path;
+};
+
+struct SceneObjectDesc {
+    std::string model;           // plant 行为空
+    std::string material;
+    unsigned int plantSeed = 0;  // 仅 plant 行
+    bool isPlant = false;
+    bool useGloss = false;       // roughnessMap 为 GLOSS 贴图
+    bool castShadow = true;
+    bool occluder = false;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 rotation = glm::vec3(0.0f);  // 角度
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+struct SceneLightDesc {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+};
+
+struct SceneDescription {
+    std::vector<SceneModelDesc> models;
+    std::vector<SceneObjectDesc> objects;
+    std::vector<SceneLightDesc> lights;
+};
+
+// 读取场景文件；文件无法打开时返回 false，格式错误的行输出警告后跳过
+bool LoadSceneDescription(const std::string& path, SceneDescription& out);
+
+#endif // SCENE_FILE_H
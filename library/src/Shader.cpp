@@ -1,4 +1,27 @@
 ﻿#include "Shader.h"  // 必须包含自身头文件
+#include <cstring>
+#include "UniformBuffers.h"
+
+unsigned int Shader::lookupCount = 0;
+unsigned int UniformHandle::handleCount = 0;
+
+namespace {
+
+// FNV-1a 64 位哈希（uniform 名称）
+uint64_t HashUniformName(const char* name) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(name); *p; ++p) {
+        h ^= *p;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+} // namespace
+
+UniformHandle::UniformHandle(const std::string& name)
+    : name(name), hash(HashUniformName(name.c_str())), index(handleCount++) {
+}
 
 // 构造函数实现
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
@@ -48,6 +71,111 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     // 删除着色器（链接后无用）
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    reflectUniforms();
+}
+
+// 链接后枚举所有活动 uniform，一次性取得 location 存入反射表
+// 基本类型数组只报告 "name[0]"，这里同时登记 "name" 和每个元素 "name[i]"
+// uniform block 按块名绑定到 UniformBuffers.h 中约定的绑定点
+void Shader::reflectUniforms() {
+    int linked = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+    if (!linked) return;
+
+    int blockCount = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    for (int i = 0; i < blockCount; ++i) {
+        char blockName[128];
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(ID, static_cast<GLuint>(i), sizeof(blockName), &length, blockName);
+        const int binding = FindUniformBlockBinding(std::string(blockName, length));
+        if (binding < 0) {
+            std::cerr << "WARNING::SHADER::UNKNOWN_UNIFORM_BLOCK: " << blockName << std::endl;
+            continue;
+        }
+        glUniformBlockBinding(ID, static_cast<GLuint>(i), static_cast<GLuint>(binding));
+    }
+
+    int activeCount = 0;
+    int maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &activeCount);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    struct ActiveUniform {
+        std::string name;
+        int size;
+    };
+    std::vector<ActiveUniform> active;
+    std::vector<char> nameBuffer(static_cast<size_t>(maxLength) + 1);
+    size_t entryCount = 0;
+    for (int i = 0; i < activeCount; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, nameBuffer.data());
+        active.push_back(ActiveUniform{ std::string(nameBuffer.data(), length), size });
+        entryCount += (size > 1) ? static_cast<size_t>(size) + 1 : 2;
+    }
+
+    size_t capacity = 16;
+    while (capacity < entryCount * 2) capacity *= 2;
+    uniformTable.assign(capacity, UniformSlot());
+
+    for (const ActiveUniform& uniform : active) {
+        // uniform block 中的成员没有 location，由 UniformBuffer 整块更新
+        const int location = glGetUniformLocation(ID, uniform.name.c_str());
+        if (location < 0) continue;
+        insertUniform(uniform.name, location);
+
+        const size_t bracket = uniform.name.size() >= 3 ? uniform.name.size() - 3 : std::string::npos;
+        if (bracket == std::string::npos || uniform.name.compare(bracket, 3, "[0]") != 0) continue;
+        const std::string base = uniform.name.substr(0, bracket);
+        insertUniform(base, location);
+        for (int element = 1; element < uniform.size; ++element) {
+            const std::string elementName = base + "[" + std::to_string(element) + "]";
+            insertUniform(elementName, glGetUniformLocation(ID, elementName.c_str()));
+        }
+    }
+}
+
+void Shader::insertUniform(const std::string& name, int location) {
+    const uint64_t hash = HashUniformName(name.c_str());
+    const size_t mask = uniformTable.size() - 1;
+    for (size_t i = static_cast<size_t>(hash) & mask; ; i = (i + 1) & mask) {
+        UniformSlot& slot = uniformTable[i];
+        if (!slot.used) {
+            slot.used = true;
+            slot.hash = hash;
+            slot.location = location;
+            slot.name = name;
+            ++uniformCount;
+            return;
+        }
+        if (slot.hash == hash && slot.name == name) return;
+    }
+}
+
+// 查反射表；着色器中不存在（或被编译器优化掉）的 uniform 返回 -1，glUniform* 会忽略它
+int Shader::findUniform(uint64_t hash, const char* name) const {
+    ++lookupCount;
+    if (uniformTable.empty()) return -1;
+    const size_t mask = uniformTable.size() - 1;
+    for (size_t i = static_cast<size_t>(hash) & mask; uniformTable[i].used; i = (i + 1) & mask) {
+        const UniformSlot& slot = uniformTable[i];
+        if (slot.hash == hash && std::strcmp(slot.name.c_str(), name) == 0) return slot.location;
+    }
+    return -1;
+}
+
+// 本着色器第一次使用该句柄：查表后按句柄序号保存
+int Shader::resolveUniform(const UniformHandle& uniform) const {
+    const int location = findUniform(uniform.hash, uniform.name.c_str());
+    if (uniform.index >= handleLocations.size()) {
+        handleLocations.resize(uniform.index + 1, kUnresolvedLocation);
+    }
+    handleLocations[uniform.index] = location;
+    return location;
 }
 
 // use 函数实现（必须带 const，与声明一致）
@@ -55,24 +183,40 @@ void Shader::use() const {
     glUseProgram(ID);
 }
 
-// 工具函数实现
+// 工具函数实现（按名字查反射表，不再调用 glGetUniformLocation）
 void Shader::setBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(findUniform(HashUniformName(name.c_str()), name.c_str()), (int)value);
 }
 void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(findUniform(HashUniformName(name.c_str()), name.c_str()), value);
 }
 void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(findUniform(HashUniformName(name.c_str()), name.c_str()), value);
 }
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform3fv(findUniform(HashUniformName(name.c_str()), name.c_str()), 1, &value[0]);
 }
 void Shader::setVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(findUniform(HashUniformName(name.c_str()), name.c_str()), x, y, z);
 }
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(findUniform(HashUniformName(name.c_str()), name.c_str()), 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setBool(const UniformHandle& uniform, bool value) const {
+    glUniform1i(getLocation(uniform), (int)value);
+}
+void Shader::setInt(const UniformHandle& uniform, int value) const {
+    glUniform1i(getLocation(uniform), value);
+}
+void Shader::setFloat(const UniformHandle& uniform, float value) const {
+    glUniform1f(getLocation(uniform), value);
+}
+void Shader::setVec3(const UniformHandle& uniform, const glm::vec3& value) const {
+    glUniform3fv(getLocation(uniform), 1, &value[0]);
+}
+void Shader::setMat4(const UniformHandle& uniform, const glm::mat4& mat) const {
+    glUniformMatrix4fv(getLocation(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
 // 错误检查函数实现
@@ -3,11 +3,33 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// 统一变量句柄：构造时计算一次名称哈希，并分配一个全局序号
+// 每个 Shader 按序号保存解析出的 location，热路径上只做一次数组下标访问，不再对字符串求哈希
+// 通常定义为静态对象或成员，同一个句柄可以用于任意多个着色器；location 随 Shader 对象一起释放，
+// 不会因为 GL 程序对象的 ID 被复用而读到旧值
+class UniformHandle {
+public:
+    explicit UniformHandle(const std::string& name);
+
+    const std::string& Name() const { return name; }
+
+private:
+    friend class Shader;
+
+    std::string name;
+    uint64_t hash;
+    unsigned int index;  // 在各 Shader 的 handleLocations 中的下标
+
+    static unsigned int handleCount;
+};
+
 // 完整的 Shader 类，声明所有成员函数（与实现一致）
 class Shader {
 public:
@@ -25,8 +47,52 @@ public:
     void setVec3(const std::string& name, float x, float y, float z) const;
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+    // 句柄版本（每帧调用的路径应使用这些重载）
+    void setBool(const UniformHandle& uniform, bool value) const;
+    void setInt(const UniformHandle& uniform, int value) const;
+    void setFloat(const UniformHandle& uniform, float value) const;
+    void setVec3(const UniformHandle& uniform, const glm::vec3& value) const;
+    void setMat4(const UniformHandle& uniform, const glm::mat4& mat) const;
+
+    // 取得 location：命中句柄缓存时直接返回，否则查一次反射表
+    int getLocation(const UniformHandle& uniform) const {
+        if (uniform.index < handleLocations.size() && handleLocations[uniform.index] != kUnresolvedLocation) {
+            return handleLocations[uniform.index];
+        }
+        return resolveUniform(uniform);
+    }
+
+    // 链接时反射得到的活动 uniform 数量（数组的每个元素单独计数）
+    size_t GetActiveUniformCount() const { return uniformCount; }
+
+    // 调试统计：所有 Shader 查反射表的次数（按名字设置 uniform、句柄首次解析都会计数）
+    // 每帧开始时读取并清零，稳定后应为 0
+    static unsigned int GetLookupCount() { return lookupCount; }
+    static void ResetLookupCount() { lookupCount = 0; }
+
 private:
+    // 反射表的一项：开放寻址（线性探测），容量为 2 的幂
+    struct UniformSlot {
+        uint64_t hash = 0;
+        int location = -1;
+        bool used = false;
+        std::string name;
+    };
+
     void checkCompileErrors(unsigned int shader, std::string type);
+    void reflectUniforms();
+    void insertUniform(const std::string& name, int location);
+    int findUniform(uint64_t hash, const char* name) const;
+    int resolveUniform(const UniformHandle& uniform) const;
+
+    std::vector<UniformSlot> uniformTable;
+    size_t uniformCount = 0;
+
+    // 按句柄序号保存的 location（-1 为着色器中不存在，kUnresolvedLocation 为尚未解析）
+    static const int kUnresolvedLocation = -2;
+    mutable std::vector<int> handleLocations;
+
+    static unsigned int lookupCount;
 };
 
 #endif
\ No newline at end of file
@@ -1,44 +1,131 @@
 #include "ShadowManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 
+namespace {
+
+const UniformHandle kCascadeIndexUniform("cascadeIndex");
+const UniformHandle kResolvePassUniform("resolvePass");
+const UniformHandle kDepthLayerUniform("depthLayer");
+const UniformHandle kEvsmUniform("evsm");
+const UniformHandle kPositiveExponentUniform("positiveExponent");
+const UniformHandle kNegativeExponentUniform("negativeExponent");
+const UniformHandle kBlurRadiusUniform("blurRadius");
+
+// 矩解析使用的纹理单元（避开 pbr 着色器用到的 0-11）
+const unsigned int kResolveDepthUnit = 12;
+const unsigned int kResolveBlurUnit = 13;
+
+// GL_EXT_texture_filter_anisotropic（glad 只生成了核心 3.3，常量在此定义）
+const GLenum kTextureMaxAnisotropy = 0x84FE;
+const GLenum kMaxTextureMaxAnisotropy = 0x84FF;
+
+bool HasAnisotropicFiltering() {
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && (std::strcmp(name, "GL_EXT_texture_filter_anisotropic") == 0 ||
+                     std::strcmp(name, "GL_ARB_texture_filter_anisotropic") == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 外接球半径按 1/16 单位取整，浮点误差不会让正交投影大小逐帧抖动
+const float kRadiusQuantum = 16.0f;
+
+// 64 位 FNV-1a
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+const char* GetShadowFilterName(ShadowFilter filter) {
+    switch (filter) {
+        case ShadowFilter::Pcf3x3: return "PCF 3x3";
+        case ShadowFilter::Hardware4: return "Hardware PCF 4-tap";
+        case ShadowFilter::Poisson16: return "Poisson 16-tap";
+        case ShadowFilter::Pcss: return "PCSS";
+        case ShadowFilter::Vsm: return "VSM";
+        case ShadowFilter::Evsm: return "EVSM";
+    }
+    return "?";
+}
+
 ShadowManager::ShadowManager()
-    : shadowMapFBO(0), shadowMapTexture(0), shadowMapSize(2048),
-      shadowShader(nullptr), shadowBias(0.005f), shadowRange(20.0f),
-      lightSpaceMatrix(1.0f) {
+    : shadowMapFBO(0), shadowMapTexture(0), depthSampler(0), shadowMapSize(2048), cascadeCount(3),
+      cacheEnabled(true), renderedCascades(0), shadowShader(nullptr),
+      momentTexture(0), blurTexture(0), momentFBO(0), momentVAO(0), momentSize(1024), momentShader(nullptr),
+      momentBlurRadius(2), evsmExponents(5.0f, 5.0f), lightBleedReduction(0.2f), minVariance(0.00002f), maxAnisotropy(1.0f),
+      shadowBias(0.02f), shadowRange(40.0f), splitLambda(0.75f), filter(ShadowFilter::Hardware4), lightSize(0.02f) {
+    for (int i = 0; i < kMaxShadowCascades; ++i) {
+        cascadeMatrices[i] = glm::mat4(1.0f);
+        cascadeSplits[i] = 0.0f;
+        cachedKeys[i] = 0;
+        cachedValid[i] = false;
+    }
 }
 
 ShadowManager::~ShadowManager() {
     Cleanup();
 }
 
-void ShadowManager::Initialize(unsigned int size) {
+void ShadowManager::Initialize(unsigned int size, int cascades) {
     shadowMapSize = size;
-    shadowBias = 0.005f;
-    shadowRange = 20.0f;
+    cascadeCount = std::min(std::max(cascades, 2), kMaxShadowCascades);
+    shadowBias = 0.02f;
+    shadowRange = 40.0f;
 
     // 创建阴影着色器
     shadowShader = new Shader("shaders/shadow.vert", "shaders/shadow.frag");
 
-    // 创建FBO
+    // 创建FBO（各级的纹理层在 BeginCascade 中挂接）
     glGenFramebuffers(1, &shadowMapFBO);
+    createShadowMapTexture();
 
-    // 创建深度纹理
-    glGenTextures(1, &shadowMapTexture);
-    glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowMapSize, shadowMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-    // 绑定FBO
     glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMapTexture, 0);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMapTexture, 0, 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // 采样器对象的参数覆盖纹理自身的参数：同一张纹理在这个单元上按原始深度读取
+    glGenSamplers(1, &depthSampler);
+    glSamplerParameteri(depthSampler, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glSamplerParameteri(depthSampler, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glSamplerParameteri(depthSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(depthSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(depthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+    shadowUniforms.Initialize(kShadowBlockBinding, sizeof(ShadowBlock));
+
+    // 矩纹理的各向异性过滤（驱动不支持时只用三线性）
+    maxAnisotropy = 1.0f;
+    if (HasAnisotropicFiltering()) {
+        glGetFloatv(kMaxTextureMaxAnisotropy, &maxAnisotropy);
+        maxAnisotropy = std::min(maxAnisotropy, 16.0f);
+    }
+
+    // 矩解析用的 FBO、VAO 和着色器只创建一次，切换过滤方式时只重建纹理
+    glGenFramebuffers(1, &momentFBO);
+    glGenVertexArrays(1, &momentVAO);
+    momentShader = new Shader("shaders/fullscreen.vert", "shaders/shadow_moments.frag");
+    momentShader->use();
+    momentShader->setInt("depthMap", kResolveDepthUnit);
+    momentShader->setInt("momentMap", kResolveBlurUnit);
+    if (IsMomentFilter(filter)) createMomentTextures();
 }
 
 void ShadowManager::Cleanup() {
@@ -50,97 +137,355 @@ void ShadowManager::Cleanup() {
         glDeleteTextures(1, &shadowMapTexture);
         shadowMapTexture = 0;
     }
+    if (depthSampler != 0) {
+        glDeleteSamplers(1, &depthSampler);
+        depthSampler = 0;
+    }
+    // Shader 没有析构函数，程序对象在这里删除
     if (shadowShader != nullptr) {
+        glDeleteProgram(shadowShader->ID);
         delete shadowShader;
         shadowShader = nullptr;
     }
+    releaseMomentTextures();
+    if (momentFBO != 0) {
+        glDeleteFramebuffers(1, &momentFBO);
+        momentFBO = 0;
+    }
+    if (momentVAO != 0) {
+        glDeleteVertexArrays(1, &momentVAO);
+        momentVAO = 0;
+    }
+    if (momentShader != nullptr) {
+        glDeleteProgram(momentShader->ID);
+        delete momentShader;
+        momentShader = nullptr;
+    }
+    shadowUniforms.Cleanup();
+}
+
+void ShadowManager::createShadowMapTexture() {
+    if (shadowMapTexture != 0) {
+        glDeleteTextures(1, &shadowMapTexture);
+    }
+
+    glGenTextures(1, &shadowMapTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMapTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, shadowMapSize, shadowMapSize, cascadeCount, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    // 深度比较 + 线性过滤：硬件对相邻 2x2 texel 分别比较后双线性插值结果
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    invalidateCache();
+    if (momentTexture != 0) createMomentTextures();
+}
+
+void ShadowManager::createMomentTextures() {
+    releaseMomentTextures();
+    invalidateCache();  // 矩要由重画的级解析得到
+
+    // 矩纹理分辨率为深度贴图的一半：每个矩 texel 平均 2x2 个深度 texel 的矩
+    momentSize = std::max(shadowMapSize / 2, 1u);
+    const bool evsm = filter == ShadowFilter::Evsm;
+    const GLint internalFormat = evsm ? GL_RGBA16F : GL_RG32F;
+    const GLenum format = evsm ? GL_RGBA : GL_RG;
+
+    glGenTextures(1, &momentTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, momentTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, momentSize, momentSize, cascadeCount, 0,
+                 format, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    if (maxAnisotropy > 1.0f) glTexParameterf(GL_TEXTURE_2D_ARRAY, kTextureMaxAnisotropy, maxAnisotropy);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);  // 分配整条 mip 链，内容在解析后生成
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // 横向模糊的中间结果（单层，逐级复用）
+    glGenTextures(1, &blurTexture);
+    glBindTexture(GL_TEXTURE_2D, blurTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, momentSize, momentSize, 0, format, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ShadowManager::releaseMomentTextures() {
+    if (momentTexture != 0) {
+        glDeleteTextures(1, &momentTexture);
+        momentTexture = 0;
+    }
+    if (blurTexture != 0) {
+        glDeleteTextures(1, &blurTexture);
+        blurTexture = 0;
+    }
+}
+
+void ShadowManager::invalidateCache() {
+    for (int i = 0; i < kMaxShadowCascades; ++i) cachedValid[i] = false;
+}
+
+void ShadowManager::SetFilter(ShadowFilter newFilter) {
+    if (newFilter == filter) return;
+    filter = newFilter;
+    if (shadowMapFBO == 0) return;
+    // VSM 与 EVSM 的格式不同，切换时也重新分配
+    if (IsMomentFilter(filter)) {
+        createMomentTextures();
+    } else if (momentTexture != 0) {
+        releaseMomentTextures();
+    }
+}
+
+void ShadowManager::SetMomentBlurRadius(int radius) {
+    radius = std::min(std::max(radius, 0), 8);
+    if (radius == momentBlurRadius) return;
+    momentBlurRadius = radius;
+    if (momentTexture != 0) invalidateCache();
+}
+
+void ShadowManager::SetEvsmExponents(float positive, float negative) {
+    const glm::vec2 exponents(std::min(std::max(positive, 0.5f), kMaxEvsmExponent),
+                              std::min(std::max(negative, 0.5f), kMaxEvsmExponent));
+    if (exponents == evsmExponents) return;
+    evsmExponents = exponents;
+    if (filter == ShadowFilter::Evsm && momentTexture != 0) invalidateCache();
+}
+
+uint64_t ShadowManager::cascadeKey(int cascade, uint64_t sceneRevision) const {
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashBytes(hash, &cascadeMatrices[cascade], sizeof(glm::mat4));
+    hash = HashBytes(hash, &sceneRevision, sizeof(sceneRevision));
+    hash = HashBytes(hash, &shadowMapSize, sizeof(shadowMapSize));
+    return hash;
+}
+
+bool ShadowManager::IsCascadeCached(int cascade, uint64_t sceneRevision) const {
+    return cacheEnabled && cachedValid[cascade] && cachedKeys[cascade] == cascadeKey(cascade, sceneRevision);
 }
 
-void ShadowManager::BeginShadowMapRender(const glm::vec3& lightPos, const glm::vec3& lightDir, bool isDirectionalLight) {
-    // 计算光源空间矩阵
-    CalculateLightSpaceMatrix(lightPos, lightDir, isDirectionalLight);
+void ShadowManager::SetCacheEnabled(bool enabled) {
+    cacheEnabled = enabled;
+    if (!enabled) invalidateCache();
+}
+
+void ShadowManager::UpdateCascades(const glm::mat4& cameraView, const glm::mat4& cameraProjection,
+                                   const glm::vec3& lightDir, const Aabb& sceneBounds) {
+    // 近/远平面和视角从透视投影矩阵反推
+    const float nearPlane = cameraProjection[3][2] / (cameraProjection[2][2] - 1.0f);
+    const float farPlane = cameraProjection[3][2] / (cameraProjection[2][2] + 1.0f);
+    const float shadowFar = std::min(farPlane, std::max(shadowRange, nearPlane * 2.0f));
+    const float tanX = 1.0f / cameraProjection[0][0];
+    const float tanY = 1.0f / cameraProjection[1][1];
+    const float diagonalSq = tanX * tanX + tanY * tanY;  // 单位深度处视锥体截面半对角线的平方
+
+    // 光源视图矩阵以世界原点为眼点、只含旋转，texel 对齐在所有帧中一致
+    const glm::vec3 up = std::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+    const glm::mat4 inverseCameraView = glm::inverse(cameraView);
+
+    // 场景包围盒离光源最近的一点（光源视空间中沿 -z 看，距离 = -z）
+    float sceneNearest = 0.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec3 point((corner & 1) ? sceneBounds.max.x : sceneBounds.min.x,
+                              (corner & 2) ? sceneBounds.max.y : sceneBounds.min.y,
+                              (corner & 4) ? sceneBounds.max.z : sceneBounds.min.z);
+        const float distance = -(lightView * glm::vec4(point, 1.0f)).z;
+        sceneNearest = corner == 0 ? distance : std::min(sceneNearest, distance);
+    }
+
+    ShadowBlock block{};
+    block.cascadeCount = cascadeCount;
+    float splitNear = nearPlane;
+    for (int i = 0; i < cascadeCount; ++i) {
+        // practical split：对数划分与均匀划分按 splitLambda 混合
+        const float p = static_cast<float>(i + 1) / cascadeCount;
+        const float logSplit = nearPlane * std::pow(shadowFar / nearPlane, p);
+        const float linearSplit = nearPlane + (shadowFar - nearPlane) * p;
+        const float splitFar = splitLambda * logSplit + (1.0f - splitLambda) * linearSplit;
+
+        // 视锥体段 [splitNear, splitFar] 的最小外接球：球心在视轴上，近/远截面的角点到球心等距
+        // 段很长时球心落在远截面之后，此时取远截面中心
+        const float centerDepth = std::min(splitFar, (splitNear + splitFar) * (1.0f + diagonalSq) * 0.5f);
+        float radius = std::sqrt((splitFar - centerDepth) * (splitFar - centerDepth) +
+                                 splitFar * splitFar * diagonalSq);
+        radius = std::ceil(radius * kRadiusQuantum) / kRadiusQuantum;
 
+        // 球心变换到光源视空间，xyz 都对齐到 texel 网格：相机移动不足一个 texel 时光源矩阵不变，缓存命中
+        const glm::vec3 centerWorld = glm::vec3(inverseCameraView * glm::vec4(0.0f, 0.0f, -centerDepth, 1.0f));
+        const glm::vec3 center = glm::vec3(lightView * glm::vec4(centerWorld, 1.0f));
+        const float texelSize = 2.0f * radius / static_cast<float>(shadowMapSize);
+        const float centerX = std::floor(center.x / texelSize) * texelSize;
+        const float centerY = std::floor(center.y / texelSize) * texelSize;
+        const float centerZ = std::floor(center.z / texelSize) * texelSize;
+
+        // 深度范围：球的远端为止；近端延伸到场景中离光源最近处，球外的遮挡物也写入深度
+        // centerZ 向下取整最多偏离一个 texel，近端多留一个 texel 保证仍包住整个球
+        const float depthNear = std::min(-centerZ - radius - texelSize, sceneNearest) - 0.5f;
+        const float depthFar = -centerZ + radius;
+
+        const glm::mat4 lightProjection = glm::ortho(centerX - radius, centerX + radius,
+                                                     centerY - radius, centerY + radius, depthNear, depthFar);
+        cascadeMatrices[i] = lightProjection * lightView;
+        cascadeSplits[i] = splitFar;
+
+        block.cascadeMatrices[i] = cascadeMatrices[i];
+        block.cascadeSplits[i] = splitFar;
+        block.cascadeTexelSizes[i] = texelSize;
+        block.cascadeDepthScales[i] = 1.0f / (depthFar - depthNear);
+        splitNear = splitFar;
+    }
+    for (int i = cascadeCount; i < kMaxShadowCascades; ++i) cascadeSplits[i] = 0.0f;
+    shadowUniforms.Update(block);
+}
+
+void ShadowManager::BeginShadowMapRender() {
     // 设置视口并绑定FBO
     glViewport(0, 0, shadowMapSize, shadowMapSize);
     glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
 
     // 启用深度测试
     glEnable(GL_DEPTH_TEST);
     glCullFace(GL_FRONT);  // 使用正面剔除减少阴影失真
 
     shadowShader->use();
-    shadowShader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
+    renderedCascades = 0;
+}
+
+void ShadowManager::BeginCascade(int cascade, uint64_t sceneRevision) {
+    cachedKeys[cascade] = cascadeKey(cascade, sceneRevision);
+    cachedValid[cascade] = true;
+    renderedCascades |= 1u << cascade;
+
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMapTexture, 0, cascade);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    shadowShader->use();
+    shadowShader->setInt(kCascadeIndexUniform, cascade);
 }
 
 void ShadowManager::EndShadowMapRender() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glCullFace(GL_BACK);  // 恢复背面剔除
+
+    if (IsMomentFilter(filter) && renderedCascades != 0) resolveMoments();
 }
 
-void ShadowManager::SetShadowMapSize(unsigned int size) {
-    if (size == shadowMapSize) return;
+void ShadowManager::resolveMoments() {
+    if (momentTexture == 0) return;
 
-    shadowMapSize = size;
+    glViewport(0, 0, momentSize, momentSize);
+    glBindFramebuffer(GL_FRAMEBUFFER, momentFBO);
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(momentVAO);
 
-    // 重新创建纹理
-    if (shadowMapTexture != 0) {
-        glDeleteTextures(1, &shadowMapTexture);
-    }
+    momentShader->use();
+    momentShader->setBool(kEvsmUniform, filter == ShadowFilter::Evsm);
+    momentShader->setFloat(kPositiveExponentUniform, evsmExponents.x);
+    momentShader->setFloat(kNegativeExponentUniform, evsmExponents.y);
+    momentShader->setInt(kBlurRadiusUniform, momentBlurRadius);
 
-    glGenTextures(1, &shadowMapTexture);
-    glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowMapSize, shadowMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    // 原始深度经不比较的采样器读取
+    glActiveTexture(GL_TEXTURE0 + kResolveDepthUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMapTexture);
+    glBindSampler(kResolveDepthUnit, depthSampler);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMapTexture, 0);
+    for (int cascade = 0; cascade < cascadeCount; ++cascade) {
+        if (!(renderedCascades & (1u << cascade))) continue;
+
+        // 横向：深度 -> 矩并模糊，写入中间纹理（此时中间纹理不能同时绑定为输入）
+        glActiveTexture(GL_TEXTURE0 + kResolveBlurUnit);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, blurTexture, 0);
+        momentShader->setInt(kResolvePassUniform, 0);
+        momentShader->setInt(kDepthLayerUniform, cascade);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        // 纵向：模糊中间纹理，写入矩纹理数组的对应层
+        glBindTexture(GL_TEXTURE_2D, blurTexture);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, momentTexture, 0, cascade);
+        momentShader->setInt(kResolvePassUniform, 1);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    glBindVertexArray(0);
+    glBindSampler(kResolveDepthUnit, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glEnable(GL_DEPTH_TEST);
+
+    // mipmap 让远处和斜视的表面也只需一次采样（三线性 + 各向异性）
+    glBindTexture(GL_TEXTURE_2D_ARRAY, momentTexture);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void ShadowManager::SetCascadeCount(int count) {
+    count = std::min(std::max(count, 2), kMaxShadowCascades);
+    if (count == cascadeCount) return;
+    cascadeCount = count;
+    if (shadowMapFBO != 0) createShadowMapTexture();
 }
 
-void ShadowManager::CalculateLightSpaceMatrix(const glm::vec3& lightPos, const glm::vec3& lightDir, bool isDirectionalLight) {
-    if (isDirectionalLight) {
-        // 方向光：使用正交投影
-        // 场景范围：15x15单位（x和z方向），高度约5单位
-        // 使用足够大的范围覆盖整个场景
-        float orthoSize = 8.0f;  // 覆盖±8单位，确保覆盖15x15的场景（从-7.5到+7.5）
-        
-        // 光源位置和观察目标
-        glm::vec3 lightTarget = glm::vec3(0.0f, 0.0f, 0.0f);  // 场景中心
-        glm::vec3 lightPos_world = lightTarget - lightDir * shadowRange * 0.5f;
-        
-        // 计算观察空间中场景的深度范围
-        // 在观察空间中，场景中心在深度 shadowRange * 0.5f = 10.0f 处
-        // 场景大小：15x15单位，前后各约7.5单位
-        // 为了保持深度精度，使用一个紧凑但足够覆盖场景的范围
-        float distanceToCenter = shadowRange * 0.5f;  // 约10.0f
-        // 使用9单位的半范围，以场景中心为中心（覆盖范围18单位）
-        // 场景需要覆盖：10.0 ± 7.5 = 2.5 到 17.5，我们的范围1.0到19.0可以覆盖
-        float depthHalfRange = 9.0f;
-        float nearPlane = distanceToCenter - depthHalfRange;  // 1.0f
-        float farPlane = distanceToCenter + depthHalfRange;   // 19.0f
+void ShadowManager::SetShadowMapSize(unsigned int size) {
+    if (size == shadowMapSize) return;
+    shadowMapSize = size;
+    if (shadowMapFBO != 0) createShadowMapTexture();
+}
 
-        // 光源空间视图矩阵
-        glm::mat4 lightView = glm::lookAt(lightPos_world, lightTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+void ShadowFilterBenchmark::Start(ShadowManager& shadowManager) {
+    savedFilter = shadowManager.GetFilter();
+    savedCache = shadowManager.IsCacheEnabled();
+    shadowManager.SetCacheEnabled(false);
+    filterIndex = 0;
+    frame = 0;
+    for (int i = 0; i < kShadowFilterCount; ++i) mainPassMs[i] = shadowPassMs[i] = 0.0;
+    shadowManager.SetFilter(static_cast<ShadowFilter>(filterIndex));
+    running = true;
+}
 
-        // 正交投影矩阵
-        glm::mat4 lightProjection = glm::ortho(-orthoSize, orthoSize, -orthoSize, orthoSize, nearPlane, farPlane);
+float ShadowFilterBenchmark::GetProgress() const {
+    const int framesPerFilter = kWarmupFrames + kMeasureFrames;
+    return static_cast<float>(filterIndex * framesPerFilter + frame) / (kShadowFilterCount * framesPerFilter);
+}
 
-        lightSpaceMatrix = lightProjection * lightView;
-    } else {
-        // 点光源：使用透视投影（如果需要的话）
-        float nearPlane = 9.0f;
-        float farPlane = shadowRange * 0.5f;
+bool ShadowFilterBenchmark::Advance(ShadowManager& shadowManager, double mainPassGpuMs, double shadowPassGpuMs) {
+    if (!running) return false;
+    if (frame >= kWarmupFrames) {
+        mainPassMs[filterIndex] += mainPassGpuMs;
+        shadowPassMs[filterIndex] += shadowPassGpuMs;
+    }
+    if (++frame < kWarmupFrames + kMeasureFrames) return false;
 
-        glm::mat4 lightView = glm::lookAt(lightPos, lightPos + lightDir, glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 lightProjection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
+    mainPassMs[filterIndex] /= kMeasureFrames;
+    shadowPassMs[filterIndex] /= kMeasureFrames;
+    frame = 0;
+    if (++filterIndex < kShadowFilterCount) {
+        shadowManager.SetFilter(static_cast<ShadowFilter>(filterIndex));
+        return false;
+    }
 
-        lightSpaceMatrix = lightProjection * lightView;
+    // 以原 3x3 PCF 的 主 pass + 阴影 pass 耗时为基准
+    const double baseline = mainPassMs[0] + shadowPassMs[0];
+    std::cout << std::fixed << std::setprecision(3);
+    for (int i = 0; i < kShadowFilterCount; ++i) {
+        const double total = mainPassMs[i] + shadowPassMs[i];
+        std::cout << "SHADOW::BENCHMARK: " << std::left << std::setw(20) << GetShadowFilterName(static_cast<ShadowFilter>(i))
+                  << std::right << " | main pass " << mainPassMs[i] << " ms | shadow pass " << shadowPassMs[i]
+                  << " ms | total " << total << " ms (x" << (baseline > 0.0 ? total / baseline : 0.0) << " vs PCF 3x3)"
+                  << std::endl;
     }
-}
+    std::cout << std::defaultfloat;
 
+    shadowManager.SetFilter(savedFilter);
+    shadowManager.SetCacheEnabled(savedCache);
+    running = false;
+    return true;
+}
@@ -2,8 +2,46 @@
 #define SHADOW_MANAGER_H
 
 #include <glad/glad.h>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include "Shader.h"
+#include "UniformBuffers.h"
+#include "EntityStore.h"
+
+// 方向光的级联阴影贴图（CSM）
+//  - 相机视锥体在 [近平面, shadowRange] 内按对数/线性混合（practical split）切成 2-4 段
+//  - 每段用其外接球拟合光源正交投影：大小与相机朝向无关，中心按 texel 对齐，相机移动/旋转时阴影不闪烁
+//  - 深度范围向光源方向延伸到场景包围盒，段外的遮挡物也能投下阴影
+//  - 各级渲染到同一张深度纹理数组的不同层；矩阵和分段深度写入 ShadowBlock，片元着色器按视空间深度选级
+//  - 阴影缓存：每级记录上次渲染时的键（光源矩阵 + 场景版本的哈希），键不变的级保留旧内容不重画；
+//    场景静止、相机和时间滑条不动时整个阴影 pass 被跳过。球心的 xyz 都按 texel 对齐，远处的级 texel 更大，
+//    相机小幅移动时保持缓存，只有近处的级重画
+//  - 纹理数组开启深度比较（GL_COMPARE_REF_TO_TEXTURE + GL_LINEAR），sampler2DArrayShadow 每次采样得到 2x2 双线性 PCF；
+//    另有一个不比较的采样器对象，供原 3x3 方案和 PCSS 的遮挡物搜索读取原始深度
+//  - VSM / EVSM：重画过的级在 pass 结束时解析为矩（深度 2x2 降采样 + 可分离高斯模糊），
+//    矩纹理数组带 mipmap 和各向异性过滤，片元着色器只需一次采样；矩纹理只在选用这两种方式时分配
+
+// 阴影过滤方式（pbr.frag 中 shadowFilter 的取值）
+enum class ShadowFilter : int {
+    Pcf3x3 = 0,   // 读取 3x3 个深度并手动比较（原方案，作为对照）
+    Hardware4,    // 4 次比较采样，每次硬件双线性 PCF，覆盖 3x3 texel
+    Poisson16,    // 16 点泊松盘比较采样，按像素随机旋转，条带变成噪点
+    Pcss,         // PCSS：泊松盘搜索遮挡物估计半影宽度，接触处硬、离遮挡物越远越软
+    Vsm,          // 方差阴影：RG32F 存 (深度, 深度²)，切比雪夫不等式估计受光比例
+    Evsm          // 指数方差阴影：RGBA16F 存正/负指数变形后深度的两组矩，漏光比 VSM 少得多
+};
+const int kShadowFilterCount = 6;
+
+// 是否需要矩纹理（VSM / EVSM）
+inline bool IsMomentFilter(ShadowFilter filter) {
+    return filter == ShadowFilter::Vsm || filter == ShadowFilter::Evsm;
+}
+
+// EVSM 用 RGBA16F 保存 exp(2c)：c 超过 ln(65504) / 2 ≈ 5.54 会溢出
+const float kMaxEvsmExponent = 5.54f;
+
+// 过滤方式的显示名称
+const char* GetShadowFilterName(ShadowFilter filter);
 
 class ShadowManager {
 public:
@@ -11,63 +49,186 @@ public:
     ~ShadowManager();
 
     // 初始化阴影贴图
-    // shadowMapSize: 阴影贴图分辨率（默认2048x2048）
-    void Initialize(unsigned int shadowMapSize = 2048);
+    // shadowMapSize: 每级阴影贴图分辨率（默认2048x2048）
+    // cascadeCount: 级联数（2-4）
+    void Initialize(unsigned int shadowMapSize = 2048, int cascadeCount = 3);
 
     // 清理资源
     void Cleanup();
 
-    // 开始渲染阴影贴图（从光源视角）
-    // lightPos: 光源位置
-    // lightDir: 光源方向（归一化）
-    // isDirectionalLight: 是否为方向光（true）或点光源（false）
-    void BeginShadowMapRender(const glm::vec3& lightPos, const glm::vec3& lightDir, bool isDirectionalLight = true);
+    // 划分级联并拟合各级的光源矩阵，上传 ShadowBlock（每帧在阴影 pass 之前调用）
+    // cameraView / cameraProjection: 主相机（透视投影）
+    // lightDir: 光线传播方向（归一化）
+    // sceneBounds: 所有投射阴影物体的包围盒（决定正交投影的近平面）
+    void UpdateCascades(const glm::mat4& cameraView, const glm::mat4& cameraProjection,
+                        const glm::vec3& lightDir, const Aabb& sceneBounds);
+
+    // 开始渲染阴影贴图（绑定 FBO 和阴影着色器），之后对每一级调用 BeginCascade 再提交绘制
+    void BeginShadowMapRender();
+
+    // 第 cascade 级的内容是否仍然有效（已按当前光源矩阵和 sceneRevision 渲染过）
+    bool IsCascadeCached(int cascade, uint64_t sceneRevision) const;
+
+    // 切换到第 cascade 级：绑定纹理数组的对应层并清空深度，记录缓存键
+    void BeginCascade(int cascade, uint64_t sceneRevision);
+
+    // 阴影缓存开关（关闭时每帧重画所有级，用于对比耗时）
+    void SetCacheEnabled(bool enabled);
+    bool IsCacheEnabled() const { return cacheEnabled; }
 
     // 结束阴影贴图渲染
     void EndShadowMapRender();
 
-    // 获取光源空间矩阵（用于在PBR着色器中采样阴影贴图）
-    glm::mat4 GetLightSpaceMatrix() const { return lightSpaceMatrix; }
+    // 级联数（2-4）；改变时重新分配纹理数组
+    void SetCascadeCount(int count);
+    int GetCascadeCount() const { return cascadeCount; }
+
+    // 第 cascade 级的光源矩阵（世界空间 -> 光源裁剪空间）和覆盖到的视空间深度
+    const glm::mat4& GetCascadeMatrix(int cascade) const { return cascadeMatrices[cascade]; }
+    float GetCascadeSplit(int cascade) const { return cascadeSplits[cascade]; }
 
-    // 获取阴影贴图纹理ID
+    // 获取阴影贴图纹理ID（GL_TEXTURE_2D_ARRAY，每级一层，纹理本身开启深度比较）
     unsigned int GetShadowMapTexture() const { return shadowMapTexture; }
 
+    // 读取原始深度的采样器对象（不比较、最近点过滤），与阴影贴图纹理一起绑定到另一个纹理单元
+    unsigned int GetDepthSampler() const { return depthSampler; }
+
+    // 阴影过滤方式；切换到 VSM / EVSM 时分配矩纹理并让所有级重画（离开时释放）
+    void SetFilter(ShadowFilter filter);
+    ShadowFilter GetFilter() const { return filter; }
+
+    // 矩纹理数组（GL_TEXTURE_2D_ARRAY，分辨率为阴影贴图的一半，带 mipmap），未使用矩方式时为 0
+    unsigned int GetMomentTexture() const { return momentTexture; }
+
+    // 矩的模糊半径（每侧的矩 texel 数，0-8）；改变时所有级重新解析
+    void SetMomentBlurRadius(int radius);
+    int GetMomentBlurRadius() const { return momentBlurRadius; }
+
+    // EVSM 的正/负指数（不超过 kMaxEvsmExponent）；改变时所有级重新解析
+    void SetEvsmExponents(float positive, float negative);
+    float GetEvsmPositiveExponent() const { return evsmExponents.x; }
+    float GetEvsmNegativeExponent() const { return evsmExponents.y; }
+
+    // 漏光削减：切比雪夫上界低于该值的部分视为全暗，其余线性拉伸到 [0, 1]（0 为不削减）
+    void SetLightBleedReduction(float amount) { lightBleedReduction = amount; }
+    float GetLightBleedReduction() const { return lightBleedReduction; }
+
+    // 方差下限（深度² 单位），避免平面上方差为 0 时出现条纹
+    void SetMinVariance(float variance) { minVariance = variance; }
+    float GetMinVariance() const { return minVariance; }
+
+    // PCSS 的光源大小：太阳角半径的正切（遮挡物每远离接收面 1 米，半影加宽 2 * lightSize 米）
+    void SetLightSize(float size) { lightSize = size; }
+    float GetLightSize() const { return lightSize; }
+
     // 设置阴影贴图大小
     void SetShadowMapSize(unsigned int size);
 
     // 获取阴影贴图大小
     unsigned int GetShadowMapSize() const { return shadowMapSize; }
 
-    // 设置阴影偏移（避免阴影失真）
+    // 设置阴影偏移（世界单位，在按 texel 大小和坡度计算的偏移之上再加的常量）
     void SetShadowBias(float bias) { shadowBias = bias; }
     float GetShadowBias() const { return shadowBias; }
 
-    // 设置阴影范围（方向光的正交投影范围）
+    // 设置阴影范围（离相机多远以内有阴影，级联划分到该距离为止）
     void SetShadowRange(float range) { shadowRange = range; }
     float GetShadowRange() const { return shadowRange; }
 
+    // 分段方式：0 为均匀划分，1 为纯对数划分，默认 0.75
+    void SetSplitLambda(float lambda) { splitLambda = lambda; }
+    float GetSplitLambda() const { return splitLambda; }
+
     // 获取阴影着色器（用于渲染阴影贴图）
     Shader* GetShadowShader() const { return shadowShader; }
 
 private:
-    // 更新光源空间矩阵
-    void CalculateLightSpaceMatrix(const glm::vec3& lightPos, const glm::vec3& lightDir, bool isDirectionalLight);
+    // 按当前大小和级联数创建深度纹理数组（同时清空缓存）
+    void createShadowMapTexture();
+
+    // 缓存键：光源矩阵（已含太阳方向和 texel 对齐后的相机位置）、场景版本、贴图大小
+    uint64_t cascadeKey(int cascade, uint64_t sceneRevision) const;
+
+    // 所有级的缓存失效（下一帧全部重画）
+    void invalidateCache();
+
+    // 按当前方式、大小和级联数创建/释放矩纹理和模糊用的中间纹理（解析用的 FBO、VAO、着色器在 Initialize 中创建）
+    void createMomentTextures();
+    void releaseMomentTextures();
+
+    // 把本次 pass 重画过的级解析为矩：深度 -> 矩并横向模糊，再纵向模糊写回矩纹理数组，最后生成 mipmap
+    void resolveMoments();
 
-    // 阴影贴图FBO和纹理
+    // 阴影贴图FBO和纹理数组
     unsigned int shadowMapFBO;
     unsigned int shadowMapTexture;
+    unsigned int depthSampler;
     unsigned int shadowMapSize;
+    int cascadeCount;
 
-    // 光源空间矩阵
-    glm::mat4 lightSpaceMatrix;
+    // 各级光源矩阵和分段深度
+    glm::mat4 cascadeMatrices[kMaxShadowCascades];
+    float cascadeSplits[kMaxShadowCascades];
+    UniformBuffer shadowUniforms;
+
+    // 各级上次渲染时的缓存键
+    uint64_t cachedKeys[kMaxShadowCascades];
+    bool cachedValid[kMaxShadowCascades];
+    bool cacheEnabled;
+
+    // 本次阴影 pass 重画过的级（位掩码）
+    unsigned int renderedCascades;
 
     // 阴影着色器
     Shader* shadowShader;
 
+    // VSM / EVSM 的矩纹理和解析资源
+    unsigned int momentTexture;
+    unsigned int blurTexture;
+    unsigned int momentFBO;
+    unsigned int momentVAO;     // 全屏三角形不需要顶点数据，核心模式下仍须绑定一个 VAO
+    unsigned int momentSize;
+    Shader* momentShader;
+    int momentBlurRadius;
+    glm::vec2 evsmExponents;
+    float lightBleedReduction;
+    float minVariance;
+    float maxAnisotropy;
+
     // 阴影参数
     float shadowBias;
     float shadowRange;
+    float splitLambda;
+    ShadowFilter filter;
+    float lightSize;
 };
 
-#endif // SHADOW_MANAGER_H
+// 在窗口中依次切换所有过滤方式的对比测试：关闭阴影缓存，每帧重画全部级（矩方式还包括解析和模糊），
+// 每种方式先跑 kWarmupFrames 帧（计时查询晚一两帧、矩纹理重新分配）再统计 kMeasureFrames 帧的平均 GPU 耗时，
+// 结束后恢复原设置并输出各方式相对 PCF 3x3 的耗时
+class ShadowFilterBenchmark {
+public:
+    static const int kWarmupFrames = 30;
+    static const int kMeasureFrames = 120;
+
+    void Start(ShadowManager& shadowManager);
+    bool IsRunning() const { return running; }
+
+    // 每帧渲染之后调用，传入最近可用的主 pass 与阴影 pass GPU 耗时；全部测完时返回 true
+    bool Advance(ShadowManager& shadowManager, double mainPassGpuMs, double shadowPassGpuMs);
+
+    // 正在测试的方式和已完成的比例（界面显示用）
+    ShadowFilter GetCurrentFilter() const { return static_cast<ShadowFilter>(filterIndex); }
+    float GetProgress() const;
 
+private:
+    bool running = false;
+    int filterIndex = 0;
+    int frame = 0;
+    ShadowFilter savedFilter = ShadowFilter::Hardware4;
+    bool savedCache = true;
+    double mainPassMs[kShadowFilterCount] = {};
+    double shadowPassMs[kShadowFilterCount] = {};
+};
+
+#endif // SHADOW_MANAGER_H
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+    : currentTask(nullptr), currentTaskCount(0), generation(0),
+      nextTask(0), pendingTasks(0), activeWorkers(0), stopping(false) {
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void ThreadPool::ParallelFor(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) return;
+    if (taskCount == 1 || workers.empty()) {
+        for (size_t i = 0; i < taskCount; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        currentTaskCount = taskCount;
+        nextTask.store(0);
+        pendingTasks.store(taskCount);
+        ++generation;
+    }
+    wakeCondition.notify_all();
+
+    RunTasks(task, taskCount);
+
+    // 等待所有任务完成，并且没有工作线程还持有本次任务的引用
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return pendingTasks.load() == 0 && activeWorkers == 0; });
+    currentTask = nullptr;
+    currentTaskCount = 0;
+}
+
+void ThreadPool::RunTasks(const std::function<void(size_t)>& task, size_t taskCount) {
+    for (;;) {
+        const size_t index = nextTask.fetch_add(1);
+        if (index >= taskCount) break;
+        task(index);
+        if (pendingTasks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            doneCondition.notify_all();
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    unsigned long long seenGeneration = 0;
+    for (;;) {
+        const std::function<void(size_t)>* task = nullptr;
+        size_t taskCount = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || (generation != seenGeneration && currentTask != nullptr); });
+            if (stopping) return;
+            seenGeneration = generation;
+            task = currentTask;
+            taskCount = currentTaskCount;
+            ++activeWorkers;
+        }
+
+        RunTasks(*task, taskCount);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeWorkers;
+        }
+        doneCondition.notify_all();
+    }
+}
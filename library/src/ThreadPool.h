@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 简单的固定大小线程池，只提供阻塞式的 ParallelFor
+// 调用线程也会参与执行任务，因此 N 个工作线程可以同时跑 N+1 个任务
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int workerCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 并行执行 task(0) ... task(taskCount - 1)，全部完成后返回
+    void ParallelFor(size_t taskCount, const std::function<void(size_t)>& task);
+
+    // 可同时运行的最大任务数（工作线程 + 调用线程）
+    unsigned int GetConcurrency() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+    // 全局共享线程池（硬件线程数 - 1 个工作线程，首次调用时创建）
+    static ThreadPool& Shared();
+
+private:
+    void WorkerLoop();
+    void RunTasks(const std::function<void(size_t)>& task, size_t taskCount);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    const std::function<void(size_t)>* currentTask;
+    size_t currentTaskCount;
+    unsigned long long generation;
+    std::atomic<size_t> nextTask;
+    std::atomic<size_t> pendingTasks;
+    unsigned int activeWorkers;
+    bool stopping;
+};
+
+#endif // THREAD_POOL_H
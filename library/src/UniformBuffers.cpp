@@ -0,0 +1,52 @@
+#include "UniformBuffers.h"
+
+#include <cstring>
+#include <iostream>
+
+int FindUniformBlockBinding(const std::string& blockName) {
+    if (blockName == "FrameBlock") return static_cast<int>(kFrameBlockBinding);
+    if (blockName == "DirectionalLightBlock") return static_cast<int>(kDirectionalLightBlockBinding);
+    if (blockName == "ClusterBlock") return static_cast<int>(kClusterBlockBinding);
+    if (blockName == "ShadowBlock") return static_cast<int>(kShadowBlockBinding);
+    if (blockName == "PointShadowBlock") return static_cast<int>(kPointShadowBlockBinding);
+    return -1;
+}
+
+UniformBuffer::~UniformBuffer() {
+    Cleanup();
+}
+
+void UniformBuffer::Initialize(unsigned int binding, size_t size) {
+    Cleanup();
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+    lastUpload.assign(size, 0);
+    hasData = false;
+}
+
+void UniformBuffer::Cleanup() {
+    if (buffer != 0) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    lastUpload.clear();
+    hasData = false;
+}
+
+bool UniformBuffer::Update(const void* data, size_t size) {
+    if (buffer == 0 || size != lastUpload.size()) {
+        std::cerr << "WARNING::UNIFORM_BUFFER::SIZE_MISMATCH: " << size << " bytes" << std::endl;
+        return false;
+    }
+    if (hasData && std::memcmp(lastUpload.data(), data, size) == 0) return false;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    std::memcpy(lastUpload.data(), data, size);
+    hasData = true;
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef UNIFORM_BUFFERS_H
+#define UNIFORM_BUFFERS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// std140 uniform block：C++ 结构体与着色器中的块声明逐字节对应
+// 着色器链接时（Shader::reflectUniforms）按块名自动绑定到下面的绑定点，
+// 所有使用同名块的程序（pbr、shadow）共享同一个缓冲
+
+const unsigned int kFrameBlockBinding = 0;
+const unsigned int kDirectionalLightBlockBinding = 1;
+const unsigned int kClusterBlockBinding = 2;
+const unsigned int kShadowBlockBinding = 3;
+const unsigned int kPointShadowBlockBinding = 4;
+
+// 块名 -> 绑定点；未知的块返回 -1
+int FindUniformBlockBinding(const std::string& blockName);
+
+// 每帧数据（pbr.vert / pbr.frag / depth.vert 中的 FrameBlock）
+struct FrameBlock {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 camPos;
+    float time;              // 秒（std140 中紧跟在 vec3 之后）
+};
+static_assert(sizeof(FrameBlock) == 144, "FrameBlock must match the std140 layout");
+
+// 级联阴影（pbr.frag / shadow.vert 中的 ShadowBlock，由 ShadowManager 每帧更新）
+// 向量的第 i 个分量对应第 i 级
+const int kMaxShadowCascades = 4;
+struct ShadowBlock {
+    glm::mat4 cascadeMatrices[kMaxShadowCascades];  // 世界空间 -> 各级光源裁剪空间
+    glm::vec4 cascadeSplits;       // 各级覆盖到的视空间深度（远端）
+    glm::vec4 cascadeTexelSizes;   // 各级一个 texel 对应的世界尺寸
+    glm::vec4 cascadeDepthScales;  // 1 / 各级正交投影的深度范围（世界单位 -> 阴影贴图深度）
+    int cascadeCount;
+    int padding[3];
+};
+static_assert(sizeof(ShadowBlock) == 320, "ShadowBlock must match the std140 layout");
+
+// 点光源阴影图集（pbr.frag / point_shadow.vert 中的 PointShadowBlock，由 PointShadowAtlas 每帧更新）
+// 槽位 s 的第 f 个面（+X -X +Y -Y +Z -Z）为 faceMatrices[s * 6 + f]，在图集中位于第 f 列、第 s 行
+const int kMaxPointShadows = 8;
+struct PointShadowBlock {
+    glm::mat4 faceMatrices[kMaxPointShadows * 6];  // 世界空间 -> 各面的透视裁剪空间（90° 视角）
+    glm::vec4 atlasParams;         // xy：一个 tile 在图集中的 uv 大小；z：1 / faceSize；w：faceSize
+};
+static_assert(sizeof(PointShadowBlock) == 3088, "PointShadowBlock must match the std140 layout");
+
+// 方向光（pbr.frag 中的 DirectionalLightBlock，目前是太阳/月光）：无衰减，方向在 CPU 上归一化
+const int kNoShadowMap = -1;
+struct DirectionalLightBlock {
+    glm::vec3 direction;     // 指向光源的单位向量（世界空间）
+    int shadowMapIndex;      // 关联的阴影贴图（0：shadowMap 级联数组 + ShadowBlock），kNoShadowMap 为不投射阴影
+    glm::vec3 radiance;      // 颜色 * 照度
+    float padding;
+};
+static_assert(sizeof(DirectionalLightBlock) == 32, "DirectionalLightBlock must match the std140 layout");
+
+// 分簇光照参数（pbr.frag 中的 ClusterBlock，见 ClusteredLighting.h）
+struct ClusterBlock {
+    glm::ivec4 gridSize;      // x, y, z 方向的簇数；w 为本帧上传的点光源数
+    glm::vec4 clusterScale;   // xy：gl_FragCoord -> 簇坐标的缩放；zw：log(视空间深度) -> 深度切片的缩放和偏移
+};
+static_assert(sizeof(ClusterBlock) == 32, "ClusterBlock must match the std140 layout");
+
+// 固定大小的 uniform 缓冲，绑定到一个绑定点
+// Update 整块上传（一次 glBufferSubData）；内容与上次相同时不上传
+class UniformBuffer {
+public:
+    UniformBuffer() = default;
+    ~UniformBuffer();
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    void Initialize(unsigned int binding, size_t size);
+    void Cleanup();
+
+    // 返回是否真正上传了数据
+    bool Update(const void* data, size_t size);
+
+    template <typename T>
+    bool Update(const T& block) { return Update(&block, sizeof(T)); }
+
+private:
+    unsigned int buffer = 0;
+    std::vector<unsigned char> lastUpload;
+    bool hasData = false;
+};
+
+#endif // UNIFORM_BUFFERS_H
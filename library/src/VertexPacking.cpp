@@ -0,0 +1,177 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const float kMaxQuantized = 65535.0f;
+const float kSnorm16 = 32767.0f;
+
+inline float SignNotZero(float v) {
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+inline glm::vec2 OctWrap(const glm::vec2& v) {
+    return glm::vec2((1.0f - std::fabs(v.y)) * SignNotZero(v.x), (1.0f - std::fabs(v.x)) * SignNotZero(v.y));
+}
+
+glm::vec3 DecodeOctahedral(const glm::vec2& e) {
+    glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+    if (n.z < 0.0f) {
+        const glm::vec2 xy = OctWrap(glm::vec2(n.x, n.y));
+        n.x = xy.x;
+        n.y = xy.y;
+    }
+    return glm::normalize(n);
+}
+
+inline float DecodeSnorm16(int16_t v) {
+    return std::max(static_cast<float>(v) / kSnorm16, -1.0f);
+}
+
+// 八面体编码：先得到连续坐标，再在相邻的 4 个量化点中选择解码误差最小的一个
+void EncodeOctahedral(const glm::vec3& normal, int16_t out[2]) {
+    const float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (!(l1 > 0.0f)) {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+    const glm::vec3 n = normal / l1;
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f) e = OctWrap(e);
+
+    const glm::vec3 target = glm::normalize(normal);
+    const float baseX = std::floor(std::min(std::max(e.x, -1.0f), 1.0f) * kSnorm16);
+    const float baseY = std::floor(std::min(std::max(e.y, -1.0f), 1.0f) * kSnorm16);
+    float bestDot = -2.0f;
+    for (int dx = 0; dx <= 1; ++dx) {
+        for (int dy = 0; dy <= 1; ++dy) {
+            const int16_t cx = static_cast<int16_t>(std::min(baseX + dx, kSnorm16));
+            const int16_t cy = static_cast<int16_t>(std::min(baseY + dy, kSnorm16));
+            const float d = glm::dot(DecodeOctahedral(glm::vec2(DecodeSnorm16(cx), DecodeSnorm16(cy))), target);
+            if (d > bestDot) {
+                bestDot = d;
+                out[0] = cx;
+                out[1] = cy;
+            }
+        }
+    }
+}
+
+} // namespace
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t abs = bits & 0x7FFFFFFFu;
+
+    if (abs >= 0x7F800000u) {
+        return sign | 0x7C00u | (abs > 0x7F800000u ? 0x0200u : 0u);  // Inf / NaN
+    }
+    if (abs >= 0x477FF000u) {
+        return sign | 0x7C00u;  // 超出半精度范围（>= 65520）
+    }
+    if (abs < 0x38800000u) {
+        // 半精度非规格化数：以 2^-24 为单位舍入（默认舍入模式为就近偶数）
+        float magnitude;
+        std::memcpy(&magnitude, &abs, sizeof(magnitude));
+        return sign | static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f));
+    }
+
+    // 规格化数：重新偏置指数，尾数按就近偶数舍入（进位可以自然进入指数）
+    uint32_t half = (abs >> 13) - (112u << 10);
+    const uint32_t remainder = abs & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+    return sign | static_cast<uint16_t>(half);
+}
+
+float HalfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    const uint32_t mantissa = value & 0x3FFu;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        const float magnitude = static_cast<float>(mantissa) / 16777216.0f;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        bits |= sign;
+    } else if (exponent == 0x1F) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+glm::vec3 GetPositionScale(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    return (boundsMax - boundsMin) / kMaxQuantized;
+}
+
+void PackVertices(const Vertex* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                  std::vector<PackedVertex>& out) {
+    out.resize(count);
+    const glm::vec3 extent = boundsMax - boundsMin;
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex& v = vertices[i];
+        PackedVertex& p = out[i];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float t = extent[axis] > 0.0f ? (v.Pos[axis] - boundsMin[axis]) / extent[axis] : 0.0f;
+            p.Pos[axis] = static_cast<uint16_t>(std::lround(std::min(std::max(t, 0.0f), 1.0f) * kMaxQuantized));
+        }
+        p.Padding = 0;
+        EncodeOctahedral(v.Normal, p.Normal);
+        p.TexCoords[0] = FloatToHalf(v.TexCoords.x);
+        p.TexCoords[1] = FloatToHalf(v.TexCoords.y);
+    }
+}
+
+Vertex UnpackVertex(const PackedVertex& packed, const glm::vec3& posScale, const glm::vec3& posBias) {
+    Vertex v;
+    v.Pos = glm::vec3(packed.Pos[0], packed.Pos[1], packed.Pos[2]) * posScale + posBias;
+    v.Normal = DecodeOctahedral(glm::vec2(DecodeSnorm16(packed.Normal[0]), DecodeSnorm16(packed.Normal[1])));
+    v.TexCoords = glm::vec2(HalfToFloat(packed.TexCoords[0]), HalfToFloat(packed.TexCoords[1]));
+    return v;
+}
+
+PackingError MeasurePackingError(const Vertex* original, const PackedVertex* packed, size_t count,
+                                 const glm::vec3& posScale, const glm::vec3& posBias) {
+    PackingError error;
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex& a = original[i];
+        const Vertex b = UnpackVertex(packed[i], posScale, posBias);
+
+        error.position = glm::max(error.position, glm::abs(a.Pos - b.Pos));
+
+        // 用 atan2(|a×b|, a·b) 计算夹角，小角度时比 acos 精确
+        const float length = glm::length(a.Normal);
+        if (length > 0.0f) {
+            const glm::vec3 n = a.Normal / length;
+            const float angle = std::atan2(glm::length(glm::cross(n, b.Normal)), glm::dot(n, b.Normal));
+            error.normalDegrees = std::max(error.normalDegrees, glm::degrees(angle));
+        }
+
+        const glm::vec2 uvError = glm::abs(a.TexCoords - b.TexCoords);
+        const float uvMax = std::max(uvError.x, uvError.y);
+        // NaN（超出半精度范围）也要视为超限
+        error.texCoord = (uvMax > error.texCoord || uvMax != uvMax) ? uvMax : error.texCoord;
+    }
+    return error;
+}
+
+bool IsPackingErrorAcceptable(const PackingError& error, const glm::vec3& posScale, const glm::vec3& posBias,
+                              float texCoordTolerance) {
+    // 半个量化步长，外加解码时 float 乘加的舍入余量（与坐标绝对值成正比）
+    const glm::vec3 magnitude = glm::abs(posBias) + posScale * kMaxQuantized;
+    const glm::vec3 positionBound = posScale * 0.5f + magnitude * (4.0f * FLT_EPSILON);
+    return error.position.x <= positionBound.x && error.position.y <= positionBound.y &&
+           error.position.z <= positionBound.z &&
+           error.normalDegrees <= kMaxPackedNormalErrorDegrees &&
+           error.texCoord <= texCoordTolerance;
+}
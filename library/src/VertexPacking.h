@@ -0,0 +1,45 @@
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// 压缩顶点格式（PackedVertex，16 字节）的编码/解码
+//  - 位置：相对网格包围盒量化为 16 位无符号整数，着色器中 aPos * posScale + posBias 还原
+//  - 法线：八面体编码后存为 2 个 16 位有符号整数（±32767）
+//  - 纹理坐标：半精度浮点
+
+// 位置反量化参数（与着色器中的 posScale / posBias 对应）
+glm::vec3 GetPositionScale(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+// 把 count 个顶点按包围盒 [boundsMin, boundsMax] 编码为 PackedVertex
+void PackVertices(const Vertex* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                  std::vector<PackedVertex>& out);
+
+// 解码单个顶点（与 pbr.vert / shadow.vert 的计算一致）
+Vertex UnpackVertex(const PackedVertex& packed, const glm::vec3& posScale, const glm::vec3& posBias);
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+// 编码误差（所有顶点中的最大值）
+struct PackingError {
+    glm::vec3 position = glm::vec3(0.0f);  // 每个轴的绝对误差
+    float normalDegrees = 0.0f;            // 法线方向的角度误差
+    float texCoord = 0.0f;                 // 纹理坐标分量的绝对误差
+};
+
+// 逐顶点解码并与原始数据比较
+PackingError MeasurePackingError(const Vertex* original, const PackedVertex* packed, size_t count,
+                                 const glm::vec3& posScale, const glm::vec3& posBias);
+
+// 误差是否在上界之内：位置不超过半个量化步长，法线不超过 kMaxPackedNormalErrorDegrees，
+// 纹理坐标不超过 texCoordTolerance（半精度在 |uv| 较大时精度下降，超出时应保留浮点格式）
+const float kMaxPackedNormalErrorDegrees = 0.01f;
+bool IsPackingErrorAcceptable(const PackingError& error, const glm::vec3& posScale, const glm::vec3& posBias,
+                              float texCoordTolerance);
+
+#endif // VERTEX_PACKING_H
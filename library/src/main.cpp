@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstring>
 #include <iostream>
 #include <windows.h>  // 用于设置控制台编码（解决乱码）
 
@@ -17,6 +18,10 @@
 #include "Camera.h"
 #include "Scene.h"
 #include "ShadowManager.h"
+#include "FrustumCuller.h"
+#include "Bvh.h"
+#include "ClusteredLighting.h"
+#include "ObjParser.h"
 
 // 相机相关全局变量
 Camera camera(glm::vec3(0.0f, 1.5f, 4.0f));  // 调整相机初始位置，使其能更好地观察图书馆
@@ -39,11 +44,40 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window);
 
 
-int main() {
+int main(int argc, char* argv[]) {
     // ========= 解决控制台乱码（Windows专属） =========
     SetConsoleOutputCP(CP_UTF8);
     SetConsoleCP(CP_UTF8);
 
+    // 无窗口基准测试：视锥体剔除（10 万个随机包围盒）
+    if (argc > 1 && std::strcmp(argv[1], "--bench-culling") == 0) {
+        return RunFrustumCullingBenchmark(100000) ? 0 : 1;
+    }
+    // 无窗口基准测试：BVH 与暴力遍历的视锥体/射线/重叠查询
+    if (argc > 1 && std::strcmp(argv[1], "--bench-bvh") == 0) {
+        return RunBvhBenchmark(100000) ? 0 : 1;
+    }
+    // 无窗口基准测试：1024 盏点光源的逐帧分簇耗时
+    if (argc > 1 && std::strcmp(argv[1], "--bench-lights") == 0) {
+        return RunClusterBinningBenchmark(1024) ? 0 : 1;
+    }
+    // 无窗口基准测试：2^20 个面的合成 OBJ，ParseOBJ 与 istringstream 参考实现的吞吐量和结果比对
+    if (argc > 1 && std::strcmp(argv[1], "--bench-obj") == 0) {
+        return RunObjParserBenchmark(1u << 20) ? 0 : 1;
+    }
+
+    // 物体布置和点光源来自场景文件，修改布置无需重新编译；--scene <路径> 换用其他场景
+    // （如 scenes/reading_hall.scene：1024 盏灯的分簇光照压力测试）
+    const char* sceneFile = "scenes/library.scene";
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--scene") == 0) sceneFile = argv[i + 1];
+    }
+    // 窗口内基准测试：依次切换所有阴影过滤方式并输出 GPU 耗时，完成后退出
+    bool benchShadows = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench-shadows") == 0) benchShadows = true;
+    }
+
     // 初始化GLFW
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -90,17 +124,20 @@ int main() {
 
     // ========= 初始化场景 =========
     Scene scene;
-    scene.Initialize();
+    scene.Initialize(sceneFile);
 
     // PBR 着色器
     Shader pbrShader("shaders/pbr.vert", "shaders/pbr.frag");
 
     // ========= 初始化阴影管理器 =========
     ShadowManager shadowManager;
-    shadowManager.Initialize(2048);  // 2048x2048阴影贴图
+    shadowManager.Initialize(2048, 3);  // 3 级级联，每级 2048x2048
+    ShadowFilterBenchmark shadowBenchmark;
+    if (benchShadows) shadowBenchmark.Start(shadowManager);
 
-    // 设置光照
-    scene.SetupLighting(pbrShader);
+    // 采样器编号和初始光照
+    scene.BindSamplers(pbrShader);
+    scene.SetupLighting();
 
     // 主循环
     while (!glfwWindowShouldClose(window)) {
@@ -117,6 +154,10 @@ int main() {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        // 上一帧按名字查 uniform 的次数（调试统计，句柄缓存生效后应为 0）
+        const unsigned int uniformLookups = Shader::GetLookupCount();
+        Shader::ResetLookupCount();
+
         // 更新视图和投影矩阵
         glm::mat4 view = camera.GetViewMatrix();
 
@@ -180,12 +221,169 @@ int main() {
             ImGui::PopStyleVar();
             ImGui::End();
         }
+
+        // ========= ImGui UI：调试统计（左上角）=========
+        {
+            ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always);
+            ImGui::Begin("##Stats", nullptr,
+                ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize |
+                ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoTitleBar |
+                ImGuiWindowFlags_AlwaysAutoResize);
+            ImGui::Text("Uniform lookups/frame: %u", uniformLookups);
+
+            // 渲染队列：实际次数 / 逐个绘制时的次数
+            const RenderQueueStats& renderStats = scene.GetRenderStats();
+            const RenderQueueStats& shadowStats = scene.GetShadowRenderStats();
+            ImGui::Text("Instances / draws: %u / %u (shadow %u / %u)", renderStats.instances, renderStats.draws,
+                        shadowStats.instances, shadowStats.draws);
+            ImGui::Text("Program switches: %u (naive %u)", renderStats.programSwitches, renderStats.naiveProgramSwitches);
+            ImGui::Text("Texture binds: %u (naive %u)", renderStats.textureBinds, renderStats.naiveTextureBinds);
+            ImGui::Text("Material / mesh changes: %u / %u", renderStats.materialChanges, renderStats.meshChanges);
+
+            // 视锥体剔除：可见 / 总数
+            const CullingStats& culling = scene.GetCullingStats();
+            ImGui::Text("Visible: %u / %u (occluded %u, culled %u)", culling.cameraVisible, culling.total,
+                        culling.occluded, culling.total - culling.cameraVisible - culling.occluded);
+
+            // 遮挡剔除开关与主 pass 的 overdraw（通过深度测试的样本数 / 屏幕像素数）
+            bool occlusionCulling = scene.IsOcclusionCullingEnabled();
+            if (ImGui::Checkbox("Occlusion culling", &occlusionCulling)) {
+                scene.SetOcclusionCulling(occlusionCulling);
+            }
+            const double screenPixels = static_cast<double>(windowWidth) * static_cast<double>(windowHeight);
+            ImGui::Text("Overdraw: %.2f", screenPixels > 0.0 ? scene.GetSamplesPassed() / screenPixels : 0.0);
+
+            // 深度预渲染开关与主 pass 的片元着色器调用次数
+            bool depthPrepass = scene.IsDepthPrepassEnabled();
+            if (ImGui::Checkbox("Depth pre-pass", &depthPrepass)) {
+                scene.SetDepthPrepass(depthPrepass);
+            }
+            uint64_t fragmentInvocations = 0;
+            if (scene.GetFragmentInvocations(fragmentInvocations)) {
+                ImGui::Text("PBR fragments: %.2f M (%.2f / pixel)", fragmentInvocations / 1.0e6,
+                            screenPixels > 0.0 ? fragmentInvocations / screenPixels : 0.0);
+            } else {
+                ImGui::Text("PBR fragments: n/a (no pipeline statistics query)");
+            }
+            if (scene.IsDepthPrepassEnabled()) {
+                ImGui::Text("Pre-pass draws: %u", scene.GetPrepassStats().draws);
+            }
+            // 开/关预渲染的对比以两者之和为准（预渲染本身的耗时不在主 pass 计时内）
+            ImGui::Text("Pre-pass + main pass GPU: %.3f ms (pre-pass %.3f, main %.3f)",
+                        scene.GetPrepassGpuMs() + scene.GetMainPassGpuMs(), scene.GetPrepassGpuMs(), scene.GetMainPassGpuMs());
+            if (scene.GetShadowCascadesRendered() == 0) {
+                ImGui::Text("Shadow casters: cached (no cascade redrawn)");
+            } else {
+                ImGui::Text("Shadow casters: %u / %u (culled %u)", culling.lightVisible, culling.shadowCasters,
+                            culling.shadowCasters - culling.lightVisible);
+            }
+
+            // 级联阴影：级数和各级覆盖到的深度
+            int cascadeCount = shadowManager.GetCascadeCount();
+            if (ImGui::SliderInt("Shadow cascades", &cascadeCount, 2, kMaxShadowCascades)) {
+                shadowManager.SetCascadeCount(cascadeCount);
+            }
+            ImGui::Text("Cascade splits: %.1f / %.1f / %.1f / %.1f m", shadowManager.GetCascadeSplit(0),
+                        shadowManager.GetCascadeSplit(1), shadowManager.GetCascadeSplit(2), shadowManager.GetCascadeSplit(3));
+
+            // 阴影缓存：静止帧不重画任何一级，阴影 pass 耗时应降到接近 0
+            bool shadowCache = shadowManager.IsCacheEnabled();
+            if (ImGui::Checkbox("Shadow cache", &shadowCache)) {
+                shadowManager.SetCacheEnabled(shadowCache);
+            }
+            ImGui::Text("Shadow pass: %d / %d cascades | CPU %.3f ms | GPU %.3f ms", scene.GetShadowCascadesRendered(),
+                        shadowManager.GetCascadeCount(), scene.GetShadowPassCpuMs(), scene.GetShadowPassGpuMs());
+
+            // 阴影过滤核：切换后比较主 pass 的 GPU 耗时（每种核各自保留平滑后的最近耗时）
+            // 计时查询晚一两帧，切换后的前几帧不计入
+            static double filterGpuMs[kShadowFilterCount] = {};
+            static int filterSettleFrames = 3;
+            int shadowFilter = static_cast<int>(shadowManager.GetFilter());
+            const double mainPassMs = scene.GetMainPassGpuMs();
+            if (filterSettleFrames > 0) {
+                --filterSettleFrames;
+            } else {
+                filterGpuMs[shadowFilter] = filterGpuMs[shadowFilter] == 0.0 ? mainPassMs
+                                                                             : filterGpuMs[shadowFilter] * 0.95 + mainPassMs * 0.05;
+            }
+            const char* filterNames[kShadowFilterCount];
+            for (int i = 0; i < kShadowFilterCount; ++i) filterNames[i] = GetShadowFilterName(static_cast<ShadowFilter>(i));
+            if (ImGui::Combo("Shadow filter", &shadowFilter, filterNames, kShadowFilterCount)) {
+                shadowManager.SetFilter(static_cast<ShadowFilter>(shadowFilter));
+                filterSettleFrames = 3;
+            }
+            if (shadowManager.GetFilter() == ShadowFilter::Pcss) {
+                float lightSize = shadowManager.GetLightSize();
+                if (ImGui::SliderFloat("Sun size (PCSS)", &lightSize, 0.002f, 0.05f, "%.3f")) {
+                    shadowManager.SetLightSize(lightSize);
+                }
+            }
+            if (IsMomentFilter(shadowManager.GetFilter())) {
+                // 矩方式：模糊半径和指数改变时所有级重新解析；漏光削减只影响采样
+                int blurRadius = shadowManager.GetMomentBlurRadius();
+                if (ImGui::SliderInt("Moment blur radius", &blurRadius, 0, 8)) {
+                    shadowManager.SetMomentBlurRadius(blurRadius);
+                }
+                float lightBleed = shadowManager.GetLightBleedReduction();
+                if (ImGui::SliderFloat("Light bleed reduction", &lightBleed, 0.0f, 0.9f, "%.2f")) {
+                    shadowManager.SetLightBleedReduction(lightBleed);
+                }
+                if (shadowManager.GetFilter() == ShadowFilter::Evsm) {
+                    float positive = shadowManager.GetEvsmPositiveExponent();
+                    float negative = shadowManager.GetEvsmNegativeExponent();
+                    // 两个滑条都要绘制，用 | 而不是 ||
+                    const bool changed = ImGui::SliderFloat("EVSM exponent +", &positive, 0.5f, kMaxEvsmExponent, "%.2f") |
+                                         ImGui::SliderFloat("EVSM exponent -", &negative, 0.5f, kMaxEvsmExponent, "%.2f");
+                    if (changed) shadowManager.SetEvsmExponents(positive, negative);
+                }
+            }
+            if (shadowBenchmark.IsRunning()) {
+                ImGui::Text("Benchmarking %s (%.0f%%)", GetShadowFilterName(shadowBenchmark.GetCurrentFilter()),
+                            shadowBenchmark.GetProgress() * 100.0f);
+            } else if (ImGui::Button("Benchmark shadow filters")) {
+                shadowBenchmark.Start(shadowManager);
+            }
+            for (int i = 0; i < kShadowFilterCount; ++i) {
+                if (filterGpuMs[i] == 0.0) continue;
+                ImGui::Text("  %-20s main pass GPU %.3f ms", GetShadowFilterName(static_cast<ShadowFilter>(i)), filterGpuMs[i]);
+            }
+
+            // 点光源阴影：占有图集槽位的灯（可用 / 占有 / 候选）与每帧重画预算
+            const PointShadowStats& pointShadowStats = scene.GetPointShadowStats();
+            int pointShadowBudget = scene.GetPointShadowBudget();
+            if (ImGui::SliderInt("Point shadow updates", &pointShadowBudget, 0, kMaxPointShadows)) {
+                scene.SetPointShadowBudget(pointShadowBudget);
+            }
+            ImGui::Text("Point shadows: %u / %u / %u lamps | updated %u | CPU %.3f ms | GPU %.3f ms",
+                        pointShadowStats.ready, pointShadowStats.resident, pointShadowStats.candidates,
+                        pointShadowStats.updated, pointShadowStats.scheduleMs, scene.GetPointShadowGpuMs());
+
+            // 点光源分簇：视锥体内的灯数、列表总长和 CPU 分簇耗时
+            const ClusterStats& clusters = scene.GetClusterStats();
+            ImGui::Text("Point lights: %u / %u (indices %u, max %u / cluster)", clusters.visibleLights, clusters.lights,
+                        clusters.lightIndices, clusters.maxClusterLights);
+            ImGui::Text("Light binning: %.3f ms", clusters.binningMs);
+
+            // 准星所指的实体（BVH 射线查询）
+            unsigned int pickedEntity = 0;
+            float pickedDistance = 0.0f;
+            if (scene.Raycast(camera.Position, camera.Front, 50.0f, pickedEntity, pickedDistance)) {
+                ImGui::Text("Looking at: entity %u (%.2f m)", pickedEntity, pickedDistance);
+            } else {
+                ImGui::Text("Looking at: -");
+            }
+            ImGui::End();
+        }
         
         // 根据时间设置光照（每帧更新，因为时间可能改变）
-        scene.SetupLighting(pbrShader);
+        scene.SetupLighting();
+
+        // 每帧数据（相机、光源空间矩阵）整块上传到 FrameBlock，pbr 和 shadow 着色器共用
+        scene.UpdateFrameUniforms(view, projection, camera.Position, currentFrame, shadowManager);
 
         // ========= 第一步：渲染阴影贴图（从光源视角）=========
         scene.RenderShadowMap(shadowManager);
+        scene.RenderPointShadows();
 
         // ========= 第二步：恢复视口 =========
         glViewport(0, 0, windowWidth, windowHeight);
@@ -194,7 +392,13 @@ int main() {
         scene.SetupShadowUniforms(pbrShader, shadowManager);
 
         // ========= 第四步：渲染主场景（应用阴影）=========
-        scene.Render(pbrShader, view, projection, camera.Position);
+        scene.Render(pbrShader);
+
+        // 阴影过滤方式对比测试（结果输出到控制台）
+        if (shadowBenchmark.IsRunning() &&
+            shadowBenchmark.Advance(shadowManager, scene.GetMainPassGpuMs(), scene.GetShadowPassGpuMs()) && benchShadows) {
+            glfwSetWindowShouldClose(window, true);
+        }
 
         // 渲染ImGui
         ImGui::Render();
@@ -212,6 +416,9 @@ int main() {
     // 清理阴影管理器
     shadowManager.Cleanup();
 
+    // 清理场景网格（GL 缓冲需在上下文销毁前删除）
+    scene.Cleanup();
+
     glfwTerminate();
     return 0;
 }